@@ -1,40 +1,301 @@
 #include <iostream>
+#include <fstream>
+#include <string>
 
 #include <cdcl/formula.hpp>
 #include <cdcl/solver.hpp>
+#include <cdcl/local_search.hpp>
+#include <cdcl/maxsat.hpp>
+#include <cdcl/symmetry.hpp>
 
 using namespace cdcl;
 
+void printUsage() {
+  std::cout << "Usage: ./cdcl [OPTIONS] <DIMAC FILE>" << std::endl;
+  std::cout << "       ./cdcl --maxsat [OPTIONS] <WCNF FILE>" << std::endl;
+  std::cout << "Options:" << std::endl;
+  std::cout << "\t--maxsat\t\t\t\tSolve a weighted partial MaxSAT instance" << std::endl;
+  std::cout << "\t--local-search=<probsat|walksat>\tSolve with local search only" << std::endl;
+  std::cout << "\t--rephase=<probsat|walksat>\t\tRephase CDCL with local search" << std::endl;
+  std::cout << "\t--flips=<n>\t\t\t\tLocal search flip budget" << std::endl;
+  std::cout << "\t--chrono=<threshold>\t\t\tBacktrack chronologically when the backjump is longer than threshold" << std::endl;
+  std::cout << "\t--vivify[=<interval>]\t\t\tVivify clauses every interval conflicts" << std::endl;
+  std::cout << "\t--stats\t\t\t\t\tPrint search statistics" << std::endl;
+  std::cout << "\t--enumerate[=<limit>]\t\t\tEnumerate all models, or at most limit" << std::endl;
+  std::cout << "\t--project=<v1,v2,...>\t\t\tProject enumerated models onto the given variables" << std::endl;
+  std::cout << "\t--count\t\t\t\t\tCount models without printing them" << std::endl;
+  std::cout << "\t--models=<file>\t\t\t\tWrite enumerated models to file" << std::endl;
+  std::cout << "\t--symmetry[=<limit>[,<nodes>]]\t\tAdd symmetry breaking clauses, over at most limit variables per generator, searching at most nodes partitions" << std::endl;
+}
+
+bool parseLocalSearchAlgorithm(std::string name, LocalSearchAlgorithm &algorithm) {
+  if (name == "probsat") {
+    algorithm = LocalSearchAlgorithm::PROBSAT;
+    return true;
+  }
+
+  if (name == "walksat") {
+    algorithm = LocalSearchAlgorithm::WALKSAT;
+    return true;
+  }
+
+  std::cerr << "Unknown local search algorithm: " << name << std::endl;
+  return false;
+}
+
+void printModel(Model &model) {
+  for (auto &assignment : model) {
+    std::cout << "\tVariable " << assignment.first << " = " << (assignment.second ? "⊤" : "⊥") << std::endl;
+  }
+}
+
+// Prints a model on a single line, e.g. "1 ¬2 3"
+void printModelLine(std::ostream &os, Model &model, std::set<int> &variables) {
+  int current_variable = 0;
+
+  for (auto variable : variables) {
+    os << Literal(variable, !model[variable]);
+
+    if (current_variable != (int) variables.size() - 1) {
+      os << " ";
+      current_variable++;
+    }
+  }
+
+  os << std::endl;
+}
+
 int main(int argc, char **argv) {
-  if (argc != 2) {
-    std::cout << "Usage: ./cdcl <DIMAC FILE>" << std::endl;
+  const char *path = nullptr;
+  bool local_search_only = false;
+  bool rephase = false;
+  LocalSearchAlgorithm algorithm = LocalSearchAlgorithm::PROBSAT;
+  long flips = -1;
+  int chrono_threshold = -1;
+  int vivify_interval = -1;
+  bool stats = false;
+  bool maxsat = false;
+  bool enumerate = false;
+  bool count_only = false;
+  long limit = -1;
+  std::set<int> projection = std::set<int>();
+  const char *models_path = nullptr;
+  bool symmetry = false;
+  int symmetry_limit = 100;
+  long symmetry_nodes = 10000;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+
+    if (arg.rfind("--local-search=", 0) == 0) {
+      local_search_only = true;
+      if (!parseLocalSearchAlgorithm(arg.substr(15), algorithm)) return EXIT_FAILURE;
+    } else if (arg.rfind("--rephase=", 0) == 0) {
+      rephase = true;
+      if (!parseLocalSearchAlgorithm(arg.substr(10), algorithm)) return EXIT_FAILURE;
+    } else if (arg.rfind("--flips=", 0) == 0) {
+      flips = std::atol(arg.substr(8).c_str());
+    } else if (arg.rfind("--chrono=", 0) == 0) {
+      chrono_threshold = std::atoi(arg.substr(9).c_str());
+    } else if (arg == "--vivify") {
+      vivify_interval = 500;
+    } else if (arg.rfind("--vivify=", 0) == 0) {
+      vivify_interval = std::atoi(arg.substr(9).c_str());
+    } else if (arg == "--stats") {
+      stats = true;
+    } else if (arg == "--maxsat") {
+      maxsat = true;
+    } else if (arg == "--enumerate") {
+      enumerate = true;
+    } else if (arg.rfind("--enumerate=", 0) == 0) {
+      enumerate = true;
+      limit = std::atol(arg.substr(12).c_str());
+    } else if (arg.rfind("--project=", 0) == 0) {
+      for (auto &variable : split(arg.substr(10), ",")) {
+        projection.insert(std::atoi(variable.c_str()));
+      }
+    } else if (arg == "--count") {
+      enumerate = true;
+      count_only = true;
+    } else if (arg.rfind("--models=", 0) == 0) {
+      models_path = argv[i] + 9;
+    } else if (arg == "--symmetry") {
+      symmetry = true;
+    } else if (arg.rfind("--symmetry=", 0) == 0) {
+      symmetry = true;
+      std::vector<std::string> parameters = split(arg.substr(11), ",");
+      symmetry_limit = std::atoi(parameters[0].c_str());
+      if (parameters.size() > 1) symmetry_nodes = std::atol(parameters[1].c_str());
+    } else if (path == nullptr && arg.rfind("--", 0) != 0) {
+      path = argv[i];
+    } else {
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Symmetry breaking removes models, and MaxSAT instances are not read as formulas
+  if (path == nullptr || (symmetry && (enumerate || maxsat))) {
+    printUsage();
     return EXIT_FAILURE;
   }
 
+  if (maxsat) {
+    WeightedFormula *weighted_formula = WeightedFormula::fromWCNF(path);
+    if (weighted_formula == nullptr) {
+      return EXIT_FAILURE;
+    }
+
+    // Report every improving solution
+    MaxSATSolver maxsat_solver = MaxSATSolver(*weighted_formula);
+    long cost = maxsat_solver.solve([](long improved, Model &) {
+      std::cout << "o " << improved << std::endl;
+    });
+
+    if (cost >= 0) {
+      std::cout << "s OPTIMUM FOUND" << std::endl;
+
+      Model model = maxsat_solver.getModel();
+      printModel(model);
+    } else {
+      std::cout << "s UNSATISFIABLE" << std::endl;
+    }
+
+    if (stats) {
+      std::cout << "Cores: " << maxsat_solver.cores() << std::endl;
+    }
+
+    delete weighted_formula;
+
+    return EXIT_SUCCESS;
+  }
+
   // Read CNF formula from file
-  Formula *formula = Formula::fromDIMACS(argv[1]);
+  Formula *formula = Formula::fromDIMACS(path);
   if (formula == nullptr) {
     return EXIT_FAILURE;
   }
 
   std::cout << "Formula: " << *formula << std::endl << std::endl;
 
+  // Symmetry breaking adds auxiliary variables, which are not printed
+  std::set<int> variables = formula->variables();
+
+  if (symmetry) {
+    SymmetryBreaker symmetry_breaker = SymmetryBreaker(*formula);
+    int generators = symmetry_breaker.findGenerators(symmetry_nodes);
+    int clauses = symmetry_breaker.breakSymmetries(*formula, symmetry_limit);
+
+    std::cout << "Symmetry generators: " << generators << std::endl;
+    std::cout << "Symmetry breaking clauses: " << clauses << std::endl << std::endl;
+  }
+
+  if (local_search_only) {
+    if (!formula->xors().empty()) {
+      std::cerr << "Local search does not support XOR constraints." << std::endl;
+      delete formula;
+      return EXIT_FAILURE;
+    }
+
+    Formula clausal = formula->encodeCardinalities();
+    LocalSearch local_search = LocalSearch(clausal, algorithm);
+    bool sat = local_search.search(Model(), flips < 0 ? 10000000 : flips);
+
+    if (sat) {
+      std::cout << "Formula is SAT" << std::endl;
+
+      // Drop the auxiliary variables of the encodings
+      Model model = Model();
+      Model clausal_model = local_search.getModel();
+      for (auto variable : variables) {
+        model[variable] = clausal_model[variable];
+      }
+
+      printModel(model);
+    } else {
+      std::cout << "Formula is UNKNOWN: " << local_search.bestUnsatisfied() << " clauses unsatisfied after " << local_search.flips() << " flips." << std::endl;
+    }
+
+    delete formula;
+
+    return EXIT_SUCCESS;
+  }
+
   // Solve
   Solver solver = Solver(*formula);
+  if (rephase) {
+    solver.setLocalSearchRephasing(algorithm, flips < 0 ? 100000 : flips);
+  }
+
+  solver.setChronologicalBacktracking(chrono_threshold);
+  solver.setVivification(vivify_interval);
+
+  if (enumerate) {
+    std::ofstream models_file;
+    if (models_path != nullptr) {
+      models_file.open(models_path);
+
+      if (!models_file.is_open()) {
+        std::cerr << "Unable to open file: " << models_path << std::endl;
+        delete formula;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::ostream &os = models_path != nullptr ? models_file : std::cout;
+    std::set<int> printed_variables = std::set<int>();
+    for (auto variable : formula->variables()) {
+      if (projection.empty() || projection.count(variable)) printed_variables.insert(variable);
+    }
+
+    std::function<bool(Model&)> callback = nullptr;
+    if (!count_only) {
+      callback = [&](Model &model) {
+        printModelLine(os, model, printed_variables);
+        return true;
+      };
+    }
+
+    long models = solver.enumerate(projection, callback, limit);
+    std::cout << "Models: " << models << std::endl;
+
+    if (stats) {
+      std::cout << "Decisions: " << solver.decisions() << std::endl;
+      std::cout << "Conflicts: " << solver.conflicts() << std::endl;
+      std::cout << "Propagations: " << solver.propagations() << std::endl;
+      std::cout << "Vivified literals: " << solver.vivifiedLiterals() << std::endl;
+      std::cout << "Vivified clauses: " << solver.vivifiedClauses() << std::endl;
+    }
+
+    delete formula;
+
+    return EXIT_SUCCESS;
+  }
+
   bool sat = solver.solve();
 
   if (sat) {
     std::cout << "Formula is SAT" << std::endl;
 
-    Model model = solver.getModel();
-
-    for (auto &assignment : model) {
-      std::cout << "\tVariable " << assignment.first << " = " << (assignment.second ? "⊤" : "⊥") << std::endl;
+    Model model = Model();
+    Model solver_model = solver.getModel();
+    for (auto variable : variables) {
+      model[variable] = solver_model[variable];
     }
+
+    printModel(model);
   } else {
     std::cout << "Formula is UNSAT." << std::endl;;
   }
 
+  if (stats) {
+    std::cout << "Decisions: " << solver.decisions() << std::endl;
+    std::cout << "Conflicts: " << solver.conflicts() << std::endl;
+    std::cout << "Propagations: " << solver.propagations() << std::endl;
+    std::cout << "Vivified literals: " << solver.vivifiedLiterals() << std::endl;
+    std::cout << "Vivified clauses: " << solver.vivifiedClauses() << std::endl;
+  }
+
   // Free memory
   if (formula !=nullptr) {
     delete formula;
@@ -42,4 +303,3 @@ int main(int argc, char **argv) {
 
   return EXIT_SUCCESS;
 }
-
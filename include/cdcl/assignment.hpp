@@ -4,6 +4,7 @@
 // Headers
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
 #include <optional>
 
 #include <cdcl/formula.hpp>
@@ -35,12 +36,17 @@ private:
   int m_decision_level;
   std::unordered_map<int, Assignment> m_assignments;
 
+  // Assigned variables in assignment order. With chronological backtracking
+  // decision levels along the trail are not necessarily monotone
+  std::vector<int> m_trail;
+
   /////////////////////////////////////////////////////////////////////////////
   // Constructors
 public: 
   PartialAssignment () {
     this->m_decision_level = -1;
     this->m_assignments = std::unordered_map<int, Assignment>();
+    this->m_trail = std::vector<int>();
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -69,16 +75,35 @@ public:
   }
 
   void assign(int variable, bool value, std::optional<Clause> clause) {
-    this->m_assignments[variable] = Assignment({value, clause, this->m_decision_level});
+    this->assign(variable, value, clause, this->m_decision_level);
+  }
+
+  void assign(int variable, bool value, std::optional<Clause> clause, int level) {
+    this->m_assignments[variable] = Assignment({value, clause, level});
+    this->m_trail.push_back(variable);
   }
 
   void unassign(int variable) {
     this->m_assignments.erase(variable);
+    this->m_trail.erase(std::find(this->m_trail.begin(), this->m_trail.end(), variable));
   }
 
   void clear() {
     this->m_decision_level = -1;
     this->m_assignments.clear();
+    this->m_trail.clear();
+  }
+
+  int level(int variable) {
+    return this->m_assignments[variable].decision_level;
+  }
+
+  std::optional<Clause> antecedent(int variable) {
+    return this->m_assignments[variable].antecedent;
+  }
+
+  std::vector<int>& trail() {
+    return this->m_trail;
   }
 
   int assignedVariables() {
@@ -103,15 +128,19 @@ public:
     return assignments_at_level;
   }
 
+  // Unassigns every variable above the given level, keeping the relative
+  // order of the remaining ones on the trail
   void backtrack(int level) {
-    auto assignment = this->m_assignments.begin();
-    while(assignment != this->m_assignments.end()) {
-      if (assignment->second.decision_level > level) {
-        assignment = this->m_assignments.erase(assignment);
+    int kept = 0;
+    for (auto variable : this->m_trail) {
+      if (this->m_assignments[variable].decision_level > level) {
+        this->m_assignments.erase(variable);
       } else {
-        assignment++;
+        this->m_trail[kept++] = variable;
       }
     }
+
+    this->m_trail.resize(kept);
   }
 
   Model getModel() {
@@ -0,0 +1,145 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Headers
+#include <iostream>
+#include <vector>
+
+#include <cdcl/clause.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace cdcl {
+
+///////////////////////////////////////////////////////////////////////////////
+// Classes
+
+// At most bound of its literals are true
+class CardinalityConstraint {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Members
+private:
+  std::vector<Literal> m_literals;
+  int m_bound;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Constructors
+
+public:
+
+  CardinalityConstraint (std::vector<Literal> literals, int bound) {
+    this->m_literals = literals;
+    this->m_bound = bound;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Methods
+
+  std::vector<Literal> literals() {
+    return this->m_literals;
+  }
+
+  int bound() {
+    return this->m_bound;
+  }
+
+  // Number of auxiliary variables used by toClauses()
+  int auxiliaryVariables() {
+    int size = this->m_literals.size();
+
+    if (this->m_bound <= 0 || this->m_bound >= size) return 0;
+
+    return (size - 1) * this->m_bound;
+  }
+
+  // Sequential counter encoding (Sinz, 2005). Auxiliary variables are
+  // numbered from first_auxiliary onwards
+  std::vector<Clause> toClauses(int first_auxiliary) {
+    std::vector<Clause> clauses = std::vector<Clause>();
+    int size = this->m_literals.size();
+    int bound = this->m_bound;
+
+    if (bound >= size) return clauses;
+
+    if (bound < 0) {
+      clauses.push_back(Clause(std::vector<Literal>()));
+      return clauses;
+    }
+
+    if (bound == 0) {
+      for (auto literal : this->m_literals) {
+        clauses.push_back(Clause(std::vector<Literal>({Literal(literal.variable(), !literal.negated())})));
+      }
+
+      return clauses;
+    }
+
+    // s(i, j): at least j of the first i + 1 literals are true
+    auto s = [&](int i, int j) { return first_auxiliary + i * bound + j; };
+    auto negation = [](Literal literal) { return Literal(literal.variable(), !literal.negated()); };
+
+    clauses.push_back(Clause(std::vector<Literal>({negation(this->m_literals[0]), Literal(s(0, 0))})));
+    for (int j = 1; j < bound; j++) {
+      clauses.push_back(Clause(std::vector<Literal>({Literal(s(0, j), true)})));
+    }
+
+    for (int i = 1; i < size - 1; i++) {
+      Literal x = negation(this->m_literals[i]);
+
+      clauses.push_back(Clause(std::vector<Literal>({x, Literal(s(i, 0))})));
+      clauses.push_back(Clause(std::vector<Literal>({Literal(s(i - 1, 0), true), Literal(s(i, 0))})));
+
+      for (int j = 1; j < bound; j++) {
+        clauses.push_back(Clause(std::vector<Literal>({x, Literal(s(i - 1, j - 1), true), Literal(s(i, j))})));
+        clauses.push_back(Clause(std::vector<Literal>({Literal(s(i - 1, j), true), Literal(s(i, j))})));
+      }
+
+      clauses.push_back(Clause(std::vector<Literal>({x, Literal(s(i - 1, bound - 1), true)})));
+    }
+
+    clauses.push_back(Clause(std::vector<Literal>({negation(this->m_literals[size - 1]), Literal(s(size - 2, bound - 1), true)})));
+
+    return clauses;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Static methods
+
+  // At least bound of the literals are true, i.e. at most size - bound of
+  // their negations are
+  static CardinalityConstraint atLeast(std::vector<Literal> literals, int bound) {
+    std::vector<Literal> negated = std::vector<Literal>();
+
+    for (auto literal : literals) {
+      negated.push_back(Literal(literal.variable(), !literal.negated()));
+    }
+
+    return CardinalityConstraint(negated, literals.size() - bound);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Operators
+
+  friend std::ostream& operator<< (std::ostream &os, CardinalityConstraint const &c) {
+    os << "( ";
+
+    int literals_counter = 0;
+    for (auto &literal : c.m_literals) {
+      os << literal;
+
+      if (literals_counter != (int) c.m_literals.size() - 1) {
+        os << " + ";
+        literals_counter++;
+      }
+    }
+
+    os << " ≤ " << c.m_bound << " )";
+
+    return os;
+  }
+
+};
+
+} // cdcl
\ No newline at end of file
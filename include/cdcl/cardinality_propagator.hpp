@@ -0,0 +1,264 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Headers
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#include <cdcl/cardinality.hpp>
+#include <cdcl/assignment.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace cdcl {
+
+///////////////////////////////////////////////////////////////////////////////
+// Types
+
+typedef struct {
+  int variable;
+  bool value;
+  int decision_level;
+} CardinalityImplication;
+
+///////////////////////////////////////////////////////////////////////////////
+// Classes
+
+// Counter based propagation of at-most-k constraints.
+//
+// Each constraint counts its true literals. Only literals becoming true can
+// change the slack (bound - count) of a constraint, so constraints are only
+// watched through the occurrences of their literals. A negative slack is a
+// conflict, a slack of zero makes every unassigned literal false.
+class CardinalityPropagator {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Members
+private:
+  // Literals are encoded as 2 * variable + negated. The literals of
+  // constraint c are m_literals[m_constraint_start[c] .. m_constraint_start[c + 1])
+  std::vector<int> m_literals;
+  std::vector<int> m_constraint_start;
+  std::vector<int> m_bounds;
+  std::vector<int> m_true_count;
+
+  // Constraints each literal occurs in
+  std::unordered_map<int, std::vector<int>> m_occurrences;
+
+  // Value (-1 if unassigned) and level of each variable as seen by the
+  // propagator, and the order in which they were seen
+  std::unordered_map<int, int> m_values;
+  std::unordered_map<int, int> m_levels;
+  std::vector<int> m_seen;
+  int m_trail_head;
+
+  std::vector<int> m_pending;
+  std::vector<char> m_is_pending;
+
+  // True literals of the constraint each implied variable was propagated
+  // from. Reason clauses are only built when conflict analysis asks for them
+  std::unordered_map<int, std::vector<int>> m_reasons;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Constructors
+
+public:
+
+  CardinalityPropagator (std::vector<CardinalityConstraint> &constraints) {
+    this->m_trail_head = 0;
+    this->m_constraint_start.push_back(0);
+
+    for (int c = 0; c < (int) constraints.size(); c++) {
+      for (auto literal : constraints[c].literals()) {
+        int encoded = 2 * literal.variable() + literal.negated();
+
+        this->m_literals.push_back(encoded);
+        this->m_occurrences[encoded].push_back(c);
+        this->m_values[literal.variable()] = -1;
+      }
+
+      this->m_constraint_start.push_back(this->m_literals.size());
+      this->m_bounds.push_back(constraints[c].bound());
+      this->m_true_count.push_back(0);
+    }
+
+    // Every constraint is checked once, to catch the trivially falsified ones
+    this->m_is_pending = std::vector<char>(constraints.size(), 1);
+    for (int c = 0; c < (int) constraints.size(); c++) {
+      this->m_pending.push_back(c);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Methods
+
+  // Reads the new assignments from the trail and propagates the constraints
+  // whose count changed. Implied variables are appended to implications.
+  // Returns the index of a conflicting constraint, or -1
+  int propagate(PartialAssignment &assignment, std::vector<CardinalityImplication> &implications) {
+    std::vector<int> &trail = assignment.trail();
+
+    for (; this->m_trail_head < (int) trail.size(); this->m_trail_head++) {
+      int variable = trail[this->m_trail_head];
+      auto value = this->m_values.find(variable);
+
+      // Not in any constraint, or already implied by the propagator
+      if (value == this->m_values.end() || value->second != -1) continue;
+
+      Literal literal = Literal(variable);
+      this->setValue(variable, assignment.value(literal), assignment.level(variable));
+    }
+
+    while (!this->m_pending.empty()) {
+      int c = this->m_pending.back();
+      this->m_pending.pop_back();
+      this->m_is_pending[c] = 0;
+
+      int slack = this->m_bounds[c] - this->m_true_count[c];
+
+      // The conflicting constraint stays pending until backtracking
+      // resolves it
+      if (slack < 0) {
+        this->markConstraint(c);
+        return c;
+      }
+      if (slack > 0) continue;
+
+      std::vector<int> true_literals = this->trueLiterals(c, this->m_bounds[c]);
+
+      int level = -1;
+      for (auto literal : true_literals) {
+        level = std::max(level, this->m_levels[literal >> 1]);
+      }
+
+      for (int i = this->m_constraint_start[c]; i < this->m_constraint_start[c + 1]; i++) {
+        int literal = this->m_literals[i];
+        int variable = literal >> 1;
+        if (this->m_values[variable] != -1) continue;
+
+        // The literal must be false
+        bool value = literal & 1;
+        this->m_reasons[variable] = true_literals;
+        this->setValue(variable, value, level);
+        implications.push_back(CardinalityImplication({variable, value, level}));
+      }
+    }
+
+    return -1;
+  }
+
+  // Undoes the variables that are no longer assigned after backtracking.
+  // Constraints containing them are checked again, as they may have to be
+  // implied by a constraint that is still at its bound. Pending constraints
+  // are kept, their literals may survive a chronological backtrack
+  void backtrack(PartialAssignment &assignment) {
+    int kept = 0;
+
+    for (auto variable : this->m_seen) {
+      if (assignment.isAssigned(variable)) {
+        this->m_seen[kept++] = variable;
+        continue;
+      }
+
+      int true_literal = 2 * variable + !this->m_values[variable];
+      for (auto c : this->m_occurrences[true_literal]) {
+        this->m_true_count[c]--;
+      }
+
+      this->m_values[variable] = -1;
+      this->m_reasons.erase(variable);
+      this->markPending(true_literal);
+      this->markPending(true_literal ^ 1);
+    }
+
+    this->m_seen.resize(kept);
+
+    // With chronological backtracking, assignments of lower levels that
+    // were not read yet can survive the backtrack. The trail is read again
+    // from the start, variables already seen are skipped
+    this->m_trail_head = 0;
+  }
+
+  bool hasReason(int variable) {
+    return this->m_reasons.count(variable);
+  }
+
+  // Reason clause of an implied variable: the implied literal or one of the
+  // literals that made the constraint reach its bound is false
+  Clause reason(int variable) {
+    std::vector<Literal> literals = std::vector<Literal>();
+    literals.push_back(Literal(variable, !this->m_values[variable]));
+
+    for (auto literal : this->m_reasons[variable]) {
+      literals.push_back(Literal(literal >> 1, !(literal & 1)));
+    }
+
+    return Clause(literals);
+  }
+
+  // Conflict clause of a constraint exceeding its bound: bound + 1 of its
+  // true literals cannot all be true
+  Clause conflictClause(int c) {
+    std::vector<Literal> literals = std::vector<Literal>();
+
+    for (auto literal : this->trueLiterals(c, this->m_bounds[c] + 1)) {
+      literals.push_back(Literal(literal >> 1, !(literal & 1)));
+    }
+
+    return Clause(literals);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Private methods
+
+private:
+
+  bool isTrue(int literal) {
+    int value = this->m_values[literal >> 1];
+    return value != -1 && value != (literal & 1);
+  }
+
+  std::vector<int> trueLiterals(int c, int limit) {
+    std::vector<int> true_literals = std::vector<int>();
+
+    for (int i = this->m_constraint_start[c]; i < this->m_constraint_start[c + 1] && (int) true_literals.size() < limit; i++) {
+      if (this->isTrue(this->m_literals[i])) {
+        true_literals.push_back(this->m_literals[i]);
+      }
+    }
+
+    return true_literals;
+  }
+
+  void setValue(int variable, bool value, int level) {
+    this->m_values[variable] = value;
+    this->m_levels[variable] = level;
+    this->m_seen.push_back(variable);
+
+    int true_literal = 2 * variable + !value;
+    for (auto c : this->m_occurrences[true_literal]) {
+      this->m_true_count[c]++;
+    }
+
+    this->markPending(true_literal);
+  }
+
+  // Marks the constraints containing the literal for propagation
+  void markPending(int literal) {
+    for (auto c : this->m_occurrences[literal]) {
+      this->markConstraint(c);
+    }
+  }
+
+  void markConstraint(int c) {
+    if (!this->m_is_pending[c]) {
+      this->m_is_pending[c] = 1;
+      this->m_pending.push_back(c);
+    }
+  }
+
+};
+
+} // cdcl
\ No newline at end of file
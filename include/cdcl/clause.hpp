@@ -73,27 +73,16 @@ public:
   }
 
   friend bool operator==(const Clause &lhs, const Clause &rhs) {
-    for (auto &literal : lhs.m_literals) {
-      if (rhs.m_literals.find(literal) == rhs.m_literals.end()) {
-        return false;
-      }
-    }
-
-    return true;
+    return lhs.m_literals == rhs.m_literals;
   }
 
+  // Shorter clauses first, then lexicographically
   friend bool operator<(const Clause &lhs, const Clause &rhs) {
-    int size_diff = lhs.m_literals.size() - rhs.m_literals.size();
-
-    if (size_diff != 0) return size_diff;
-
-    for (auto &literal : lhs.m_literals) {
-      if (rhs.m_literals.find(literal) == rhs.m_literals.end()) {
-        return -1;
-      }
+    if (lhs.m_literals.size() != rhs.m_literals.size()) {
+      return lhs.m_literals.size() < rhs.m_literals.size();
     }
 
-    return +1;
+    return lhs.m_literals < rhs.m_literals;
   }
   
 };
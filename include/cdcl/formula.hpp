@@ -9,6 +9,8 @@
 #include <string>
 
 #include <cdcl/clause.hpp>
+#include <cdcl/xor.hpp>
+#include <cdcl/cardinality.hpp>
 #include <cdcl/utils.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -26,6 +28,8 @@ class Formula {
 private:
   std::set<int> m_variables;
   std::set<Clause> m_clauses;
+  std::vector<XorConstraint> m_xors;
+  std::vector<CardinalityConstraint> m_cardinalities;
 
   /////////////////////////////////////////////////////////////////////////////
   // Constructors
@@ -59,12 +63,14 @@ public:
   Formula () {
     this->m_variables = std::set<int>();
     this->m_clauses = std::set<Clause>();
+    this->m_xors = std::vector<XorConstraint>();
+    this->m_cardinalities = std::vector<CardinalityConstraint>();
   }
 
   /////////////////////////////////////////////////////////////////////////////
   // Methods
 
-  std::set<int> variables() {
+  std::set<int>& variables() {
     return m_variables;
   }
 
@@ -72,6 +78,14 @@ public:
     return m_clauses;
   }
 
+  std::vector<XorConstraint>& xors() {
+    return m_xors;
+  }
+
+  std::vector<CardinalityConstraint>& cardinalities() {
+    return m_cardinalities;
+  }
+
   void addClause(Clause &clause) {
     this->m_clauses.insert(clause);
 
@@ -80,6 +94,48 @@ public:
     }
   }
 
+  // Variables of the clause are kept, they may occur in other constraints
+  void removeClause(Clause &clause) {
+    this->m_clauses.erase(clause);
+  }
+
+  void addXor(XorConstraint &constraint) {
+    this->m_xors.push_back(constraint);
+
+    for (auto variable : constraint.variables()) {
+      this->m_variables.insert(variable);
+    }
+  }
+
+  void addCardinality(CardinalityConstraint &constraint) {
+    this->m_cardinalities.push_back(constraint);
+
+    for (auto literal : constraint.literals()) {
+      this->m_variables.insert(literal.variable());
+    }
+  }
+
+  // Copy of the formula where cardinality constraints are encoded into
+  // clauses, for the algorithms that only handle clauses
+  Formula encodeCardinalities() {
+    Formula encoded = Formula(this->m_clauses);
+
+    for (auto &constraint : this->m_xors) {
+      encoded.addXor(constraint);
+    }
+
+    int next_variable = this->m_variables.empty() ? 1 : *this->m_variables.rbegin() + 1;
+    for (auto &constraint : this->m_cardinalities) {
+      for (auto &clause : constraint.toClauses(next_variable)) {
+        encoded.addClause(clause);
+      }
+
+      next_variable += constraint.auxiliaryVariables();
+    }
+
+    return encoded;
+  }
+
   /////////////////////////////////////////////////////////////////////////////
   // Static methods
 
@@ -102,7 +158,7 @@ public:
       return nullptr;
     }
 
-    if (parsed_line[0] != "p" || parsed_line[1] != "cnf") {
+    if (parsed_line[0] != "p" || (parsed_line[1] != "cnf" && parsed_line[1] != "cnf+")) {
       std::cerr << "Only cnf formulas are supported." << std::endl;
       return nullptr;
     } 
@@ -116,28 +172,83 @@ public:
     }
 
     std::vector<Clause> clauses;
+    std::vector<XorConstraint> xors;
+    std::vector<CardinalityConstraint> cardinalities;
     while(getline(file, line)) {
+      if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+      // XOR constraints, as in the CryptoMiniSat extension: "x1 -2 3 0"
+      // means 1 ⊕ ¬2 ⊕ 3 = ⊤
+      bool is_xor = line.size() > 0 && line[0] == 'x';
+      if (is_xor) {
+        line = line.substr(1);
+      }
+
       std::vector<std::string> raw_literals = split(line, " ");
       
       if (raw_literals.size() == 0) continue;
 
       std::vector<Literal> literals = std::vector<Literal>();
-      for (auto &raw_literal : raw_literals) {
+      std::string cardinality_operator = "";
+      int bound = 0;
+      for (int i = 0; i < (int) raw_literals.size(); i++) {
+        std::string &raw_literal = raw_literals[i];
+
         // Terminator
         if (raw_literal == "0") {
           break;
         }
 
+        if (raw_literal.empty()) continue;
+
+        // Cardinality constraints, as in the MiniCard CNF+ format:
+        // "1 -2 3 <= 2" means at most 2 of 1, ¬2, 3 are true
+        if (raw_literal == "<=" || raw_literal == ">=") {
+          cardinality_operator = raw_literal;
+          bound = i + 1 < (int) raw_literals.size() ? std::atoi(raw_literals[i + 1].c_str()) : 0;
+          break;
+        }
+
         bool negated = raw_literal[0] == '-';
         int variable = negated ? std::atoi(raw_literal.substr(1).c_str()) : std::atoi(raw_literal.c_str());
     
         literals.push_back(Literal(variable, negated));
       }
 
+      if (cardinality_operator == "<=") {
+        cardinalities.push_back(CardinalityConstraint(literals, bound));
+        continue;
+      }
+
+      if (cardinality_operator == ">=") {
+        cardinalities.push_back(CardinalityConstraint::atLeast(literals, bound));
+        continue;
+      }
+
+      if (is_xor) {
+        std::vector<int> variables = std::vector<int>();
+        bool rhs = true;
+
+        for (auto &literal : literals) {
+          variables.push_back(literal.variable());
+          rhs = rhs != literal.negated();
+        }
+
+        xors.push_back(XorConstraint(variables, rhs));
+        continue;
+      }
+
       clauses.push_back(Clause(literals));
     }
 
     Formula *formula = new Formula(clauses);
+    for (auto &constraint : xors) {
+      formula->addXor(constraint);
+    }
+
+    for (auto &constraint : cardinalities) {
+      formula->addCardinality(constraint);
+    }
 
     return formula;
   }
@@ -147,11 +258,30 @@ public:
 
   friend std::ostream& operator<< (std::ostream &os, Formula const &f) { 
     int current_clause = 0;
+    int num_constraints = f.m_clauses.size() + f.m_xors.size() + f.m_cardinalities.size();
 
     for (auto &clause : f.m_clauses) {
       os << clause;
 
-      if (current_clause != f.m_clauses.size() - 1) {
+      if (current_clause != num_constraints - 1) {
+        os << " ∧ ";
+        current_clause++;
+      }
+    }
+
+    for (auto &constraint : f.m_xors) {
+      os << constraint;
+
+      if (current_clause != num_constraints - 1) {
+        os << " ∧ ";
+        current_clause++;
+      }
+    }
+
+    for (auto &constraint : f.m_cardinalities) {
+      os << constraint;
+
+      if (current_clause != num_constraints - 1) {
         os << " ∧ ";
         current_clause++;
       }
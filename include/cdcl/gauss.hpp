@@ -0,0 +1,471 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Headers
+#include <vector>
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <unordered_map>
+
+#include <cdcl/xor.hpp>
+#include <cdcl/assignment.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace cdcl {
+
+///////////////////////////////////////////////////////////////////////////////
+// Types
+
+typedef struct {
+  int variable;
+  bool value;
+  int decision_level;
+} XorImplication;
+
+///////////////////////////////////////////////////////////////////////////////
+// Classes
+
+// Gauss-Jordan elimination over the XOR constraints of a formula.
+//
+// The matrix is kept in reduced row echelon form, one column per variable,
+// with rows bit-packed into 64-bit words. Each row has a pivot column which
+// appears in no other row: whenever the pivot of a row gets assigned while
+// the row still has unassigned columns, the pivot is moved to one of them.
+// As long as this holds, a row with a single unassigned column is an
+// implication and a fully assigned row with the wrong parity is a conflict.
+//
+// Every row watches its pivot and another unassigned column, so only rows
+// watching a newly assigned variable are revisited.
+class GaussJordan {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Members
+private:
+  int m_num_columns;
+  int m_num_words;
+  int m_num_rows;
+  bool m_inconsistent;
+
+  std::vector<int> m_column_variables;
+  std::unordered_map<int, int> m_variable_columns;
+
+  // Row r is stored in m_matrix[r * m_num_words .. (r + 1) * m_num_words)
+  std::vector<uint64_t> m_matrix;
+  std::vector<char> m_rhs;
+  std::vector<int> m_pivots;
+
+  // Current assignment of the columns, bit-packed like the rows
+  std::vector<uint64_t> m_assigned;
+  std::vector<uint64_t> m_values;
+  std::vector<int> m_levels;
+
+  // Assigned columns, in the order they were assigned
+  std::vector<int> m_column_trail;
+
+  // Rows watching each column and columns watched by each row. Watch lists
+  // are cleaned lazily: entries of rows that no longer watch the column are
+  // dropped when the list is visited
+  std::vector<std::vector<int>> m_watches;
+  std::vector<std::pair<int, int>> m_watched;
+
+  std::vector<int> m_dirty_rows;
+  std::vector<char> m_dirty;
+
+  // Number of trail entries already seen
+  int m_trail_head;
+
+  // Row each implied variable was propagated from. Reason clauses are only
+  // built from them when conflict analysis asks for them
+  std::unordered_map<int, std::vector<uint64_t>> m_reasons;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Constructors
+
+public:
+
+  GaussJordan (std::vector<XorConstraint> &constraints) {
+    this->m_inconsistent = false;
+    this->m_trail_head = 0;
+
+    for (auto &constraint : constraints) {
+      for (auto variable : constraint.variables()) {
+        if (!this->m_variable_columns.count(variable)) {
+          this->m_variable_columns[variable] = this->m_column_variables.size();
+          this->m_column_variables.push_back(variable);
+        }
+      }
+    }
+
+    this->m_num_columns = this->m_column_variables.size();
+    this->m_num_words = (this->m_num_columns + 63) / 64;
+    this->m_num_rows = constraints.size();
+
+    this->m_matrix = std::vector<uint64_t>(this->m_num_rows * this->m_num_words, 0);
+    this->m_rhs = std::vector<char>(this->m_num_rows, 0);
+    for (int r = 0; r < this->m_num_rows; r++) {
+      for (auto variable : constraints[r].variables()) {
+        this->setBit(this->row(r), this->m_variable_columns[variable]);
+      }
+
+      this->m_rhs[r] = constraints[r].rhs();
+    }
+
+    this->eliminate();
+
+    this->m_assigned = std::vector<uint64_t>(this->m_num_words, 0);
+    this->m_values = std::vector<uint64_t>(this->m_num_words, 0);
+    this->m_levels = std::vector<int>(this->m_num_columns, -1);
+    this->m_watches = std::vector<std::vector<int>>(this->m_num_columns);
+    this->m_watched = std::vector<std::pair<int, int>>(this->m_num_rows, std::make_pair(-1, -1));
+    this->m_dirty = std::vector<char>(this->m_num_rows, 0);
+    this->markAllDirty();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Methods
+
+  // True if the XOR constraints are unsatisfiable on their own
+  bool inconsistent() {
+    return this->m_inconsistent;
+  }
+
+  int rows() {
+    return this->m_num_rows;
+  }
+
+  // Reads the new assignments from the trail and revisits the rows watching
+  // them. Implied variables are appended to implications. Returns the index
+  // of a conflicting row, or -1
+  int propagate(PartialAssignment &assignment, std::vector<XorImplication> &implications) {
+    if (this->m_num_rows == 0) return -1;
+
+    std::vector<int> &trail = assignment.trail();
+
+    for (; this->m_trail_head < (int) trail.size(); this->m_trail_head++) {
+      int variable = trail[this->m_trail_head];
+      auto column = this->m_variable_columns.find(variable);
+      if (column == this->m_variable_columns.end()) continue;
+
+      // Already implied by the engine
+      if (this->testBit(this->m_assigned.data(), column->second)) continue;
+
+      this->setColumn(column->second, this->assignedValue(assignment, variable), assignment.level(variable));
+      this->markWatchersDirty(column->second);
+    }
+
+    while (!this->m_dirty_rows.empty()) {
+      int r = this->m_dirty_rows.back();
+      this->m_dirty_rows.pop_back();
+      this->m_dirty[r] = 0;
+
+      // The conflicting row stays dirty until backtracking resolves it
+      if (!this->updateRow(r, implications)) {
+        this->markDirty(r);
+        return r;
+      }
+    }
+
+    return -1;
+  }
+
+  // Synchronizes with the assignment after backtracking. Only the rows
+  // containing a column that is no longer assigned are revisited
+  void backtrack(PartialAssignment &assignment) {
+    std::vector<uint64_t> unassigned = std::vector<uint64_t>(this->m_num_words, 0);
+    bool any_unassigned = false;
+    int kept = 0;
+
+    for (auto column : this->m_column_trail) {
+      int variable = this->m_column_variables[column];
+
+      if (assignment.isAssigned(variable)) {
+        this->m_column_trail[kept++] = column;
+        continue;
+      }
+
+      uint64_t mask = uint64_t(1) << (column & 63);
+      this->m_assigned[column >> 6] &= ~mask;
+      this->m_values[column >> 6] &= ~mask;
+      this->m_levels[column] = -1;
+      this->m_reasons.erase(variable);
+
+      unassigned[column >> 6] |= mask;
+      any_unassigned = true;
+    }
+
+    this->m_column_trail.resize(kept);
+
+    if (any_unassigned) {
+      for (int r = 0; r < this->m_num_rows; r++) {
+        const uint64_t *words = this->row(r);
+
+        for (int w = 0; w < this->m_num_words; w++) {
+          if (words[w] & unassigned[w]) {
+            this->markDirty(r);
+            break;
+          }
+        }
+      }
+    }
+
+    // With chronological backtracking, assignments of lower levels that
+    // were not read yet can survive the backtrack. The trail is read again
+    // from the start, columns already assigned are skipped
+    this->m_trail_head = 0;
+  }
+
+  // Reason clause of a variable implied by Gauss-Jordan elimination: the
+  // implied literal or the negation of the current value of every other
+  // variable of the row it was propagated from
+  Clause reason(int variable, PartialAssignment &assignment) {
+    std::vector<Literal> literals = std::vector<Literal>();
+    std::vector<uint64_t> &row = this->m_reasons[variable];
+
+    for (int w = 0; w < this->m_num_words; w++) {
+      for (uint64_t bits = row[w]; bits; bits &= bits - 1) {
+        int other = this->m_column_variables[w * 64 + this->lowestBit(bits)];
+        bool value = this->assignedValue(assignment, other);
+
+        literals.push_back(other == variable ? Literal(other, !value) : Literal(other, value));
+      }
+    }
+
+    return Clause(literals);
+  }
+
+  bool hasReason(int variable) {
+    return this->m_reasons.count(variable);
+  }
+
+  // Conflict clause of a fully assigned row with the wrong parity: every
+  // literal is false under the current assignment
+  Clause conflictClause(int r, PartialAssignment &assignment) {
+    std::vector<Literal> literals = std::vector<Literal>();
+
+    const uint64_t *words = this->row(r);
+
+    for (int w = 0; w < this->m_num_words; w++) {
+      for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+        int variable = this->m_column_variables[w * 64 + this->lowestBit(bits)];
+        literals.push_back(Literal(variable, this->assignedValue(assignment, variable)));
+      }
+    }
+
+    return Clause(literals);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Private methods
+
+private:
+
+  uint64_t* row(int r) {
+    return this->m_matrix.data() + r * this->m_num_words;
+  }
+
+  bool testBit(const uint64_t *words, int column) {
+    return (words[column >> 6] >> (column & 63)) & 1;
+  }
+
+  void setBit(uint64_t *words, int column) {
+    words[column >> 6] |= uint64_t(1) << (column & 63);
+  }
+
+  static int lowestBit(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & 1)) {
+      word >>= 1;
+      bit++;
+    }
+    return bit;
+#endif
+  }
+
+  bool assignedValue(PartialAssignment &assignment, int variable) {
+    Literal literal = Literal(variable);
+    return assignment.value(literal);
+  }
+
+  void setColumn(int column, bool value, int level) {
+    uint64_t mask = uint64_t(1) << (column & 63);
+
+    this->m_levels[column] = level;
+    this->m_column_trail.push_back(column);
+    this->m_assigned[column >> 6] |= mask;
+    if (value) {
+      this->m_values[column >> 6] |= mask;
+    } else {
+      this->m_values[column >> 6] &= ~mask;
+    }
+  }
+
+  // target ^= source, word by word (vectorized by the compiler)
+  void addRow(int target, int source) {
+    uint64_t *__restrict target_words = this->row(target);
+    const uint64_t *__restrict source_words = this->row(source);
+
+    for (int w = 0; w < this->m_num_words; w++) {
+      target_words[w] ^= source_words[w];
+    }
+
+    this->m_rhs[target] ^= this->m_rhs[source];
+  }
+
+  // Makes column the pivot of row r, removing it from every other row
+  void pivot(int r, int column) {
+    for (int other = 0; other < this->m_num_rows; other++) {
+      if (other != r && this->testBit(this->row(other), column)) {
+        this->addRow(other, r);
+        this->markDirty(other);
+      }
+    }
+
+    this->m_pivots[r] = column;
+  }
+
+  // Initial Gauss-Jordan elimination. Empty rows are dropped, an empty row
+  // with odd parity makes the system inconsistent
+  void eliminate() {
+    this->m_pivots = std::vector<int>(this->m_num_rows, -1);
+
+    int next_row = 0;
+    for (int column = 0; column < this->m_num_columns && next_row < this->m_num_rows; column++) {
+      int found = -1;
+      for (int r = next_row; r < this->m_num_rows; r++) {
+        if (this->testBit(this->row(r), column)) {
+          found = r;
+          break;
+        }
+      }
+
+      if (found == -1) continue;
+
+      this->swapRows(found, next_row);
+      this->pivot(next_row, column);
+      next_row++;
+    }
+
+    for (int r = next_row; r < this->m_num_rows; r++) {
+      if (this->m_rhs[r]) this->m_inconsistent = true;
+    }
+
+    this->m_num_rows = next_row;
+    this->m_matrix.resize(this->m_num_rows * this->m_num_words);
+    this->m_rhs.resize(this->m_num_rows);
+    this->m_pivots.resize(this->m_num_rows);
+  }
+
+  void swapRows(int a, int b) {
+    if (a == b) return;
+
+    std::swap_ranges(this->row(a), this->row(a) + this->m_num_words, this->row(b));
+    std::swap(this->m_rhs[a], this->m_rhs[b]);
+  }
+
+  void markDirty(int r) {
+    if (this->m_dirty.empty() || this->m_dirty[r]) return;
+
+    this->m_dirty[r] = 1;
+    this->m_dirty_rows.push_back(r);
+  }
+
+  void markAllDirty() {
+    for (int r = 0; r < this->m_num_rows; r++) {
+      this->markDirty(r);
+    }
+  }
+
+  void markWatchersDirty(int column) {
+    std::vector<int> &watchers = this->m_watches[column];
+
+    int kept = 0;
+    for (auto r : watchers) {
+      if (this->m_watched[r].first != column && this->m_watched[r].second != column) continue;
+
+      watchers[kept++] = r;
+      this->markDirty(r);
+    }
+
+    watchers.resize(kept);
+  }
+
+  void watch(int r, int first, int second) {
+    std::pair<int, int> &watched = this->m_watched[r];
+    if (watched.first == first && watched.second == second) return;
+
+    if (watched.first != first && watched.second != first) this->m_watches[first].push_back(r);
+    if (watched.first != second && watched.second != second) this->m_watches[second].push_back(r);
+
+    watched = std::make_pair(first, second);
+  }
+
+  // Restores the invariants of row r. Returns false on conflict
+  bool updateRow(int r, std::vector<XorImplication> &implications) {
+    uint64_t *words = this->row(r);
+
+    // Find up to two unassigned columns and the parity of the assigned ones
+    int unassigned[2] = {-1, -1};
+    int num_unassigned = 0;
+    bool parity = false;
+
+    for (int w = 0; w < this->m_num_words; w++) {
+      uint64_t free_bits = words[w] & ~this->m_assigned[w];
+      parity ^= std::bitset<64>(words[w] & this->m_assigned[w] & this->m_values[w]).count() & 1;
+
+      while (free_bits && num_unassigned < 2) {
+        unassigned[num_unassigned++] = w * 64 + this->lowestBit(free_bits);
+        free_bits &= free_bits - 1;
+      }
+
+      if (free_bits) num_unassigned++;
+    }
+
+    if (num_unassigned == 0) {
+      return parity == (bool) this->m_rhs[r];
+    }
+
+    // Keep the pivot unassigned
+    int pivot = this->m_pivots[r];
+    if (this->testBit(this->m_assigned.data(), pivot)) {
+      pivot = unassigned[0];
+      this->pivot(r, pivot);
+    }
+
+    if (num_unassigned == 1) {
+      int variable = this->m_column_variables[pivot];
+      bool value = parity != (bool) this->m_rhs[r];
+
+      // The implied literal belongs to the highest level of the others. Some
+      // of them may be implications not yet on the trail, so the levels are
+      // read from the columns
+      int level = -1;
+      for (int w = 0; w < this->m_num_words; w++) {
+        for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+          int c = w * 64 + this->lowestBit(bits);
+          if (c != pivot) level = std::max(level, this->m_levels[c]);
+        }
+      }
+
+      this->m_reasons[variable] = std::vector<uint64_t>(words, words + this->m_num_words);
+      this->setColumn(pivot, value, level);
+      this->markWatchersDirty(pivot);
+      implications.push_back(XorImplication({variable, value, level}));
+
+      return true;
+    }
+
+    int other = unassigned[0] != pivot ? unassigned[0] : unassigned[1];
+    this->watch(r, pivot, other);
+
+    return true;
+  }
+
+};
+
+} // cdcl
\ No newline at end of file
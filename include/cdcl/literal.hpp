@@ -3,6 +3,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Headers
 #include <iostream>
+#include <tuple>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Namespace
@@ -0,0 +1,335 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Headers
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include <cdcl/formula.hpp>
+#include <cdcl/assignment.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace cdcl {
+
+///////////////////////////////////////////////////////////////////////////////
+// Types
+
+enum LocalSearchAlgorithm {
+  PROBSAT,
+  WALKSAT
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Classes
+
+class LocalSearch {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Members
+private:
+  LocalSearchAlgorithm m_algorithm;
+  std::mt19937 m_random;
+
+  // Literals are encoded as 2 * variable + negated. The literals of clause c
+  // are stored in m_literals[m_clause_start[c] .. m_clause_start[c + 1])
+  std::vector<int> m_literals;
+  std::vector<int> m_clause_start;
+
+  // Clauses each literal occurs in, flattened the same way
+  std::vector<int> m_occurrences;
+  std::vector<int> m_occurrence_start;
+
+  // Per clause state: number of true literals and XOR of the variables of
+  // the true literals, which is the critical variable when the count is 1
+  std::vector<int> m_true_count;
+  std::vector<int> m_true_xor;
+
+  // Unsatisfied clauses, with the position of each clause in the list (or -1)
+  std::vector<int> m_unsatisfied;
+  std::vector<int> m_unsatisfied_position;
+
+  std::vector<int> m_variables;
+  std::vector<char> m_values;
+  std::vector<int> m_break_count;
+
+  std::vector<char> m_best_values;
+  int m_best_unsatisfied;
+  long m_flips;
+
+  // ProbSAT polynomial break function, precomputed for each break count
+  double m_cb;
+  double m_eps;
+  std::vector<double> m_break_score;
+  std::vector<double> m_probabilities;
+
+  // WalkSAT noise
+  double m_noise;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Constructors
+
+public:
+
+  LocalSearch (Formula &formula, LocalSearchAlgorithm algorithm = PROBSAT, unsigned int seed = 0) {
+    this->m_algorithm = algorithm;
+    this->m_random = std::mt19937(seed);
+    this->m_cb = 2.3;
+    this->m_eps = 1.0;
+    this->m_noise = 0.567;
+    this->m_best_unsatisfied = -1;
+    this->m_flips = 0;
+
+    int max_variable = 0;
+    for (auto variable : formula.variables()) {
+      this->m_variables.push_back(variable);
+      max_variable = std::max(max_variable, variable);
+    }
+
+    int num_literals = 2 * (max_variable + 1);
+    std::vector<int> occurrences_count = std::vector<int>(num_literals, 0);
+
+    // Flatten clauses
+    this->m_clause_start.push_back(0);
+    for (auto clause : formula.clauses()) {
+      for (auto literal : clause.literals()) {
+        int encoded = 2 * literal.variable() + literal.negated();
+        this->m_literals.push_back(encoded);
+        occurrences_count[encoded]++;
+      }
+
+      this->m_clause_start.push_back(this->m_literals.size());
+    }
+
+    // Flatten occurrence lists
+    this->m_occurrence_start = std::vector<int>(num_literals + 1, 0);
+    for (int literal = 0; literal < num_literals; literal++) {
+      this->m_occurrence_start[literal + 1] = this->m_occurrence_start[literal] + occurrences_count[literal];
+    }
+
+    std::vector<int> next = std::vector<int>(this->m_occurrence_start.begin(), this->m_occurrence_start.end() - 1);
+    this->m_occurrences = std::vector<int>(this->m_literals.size());
+    int num_clauses = this->numClauses();
+    for (int clause = 0; clause < num_clauses; clause++) {
+      for (int i = this->m_clause_start[clause]; i < this->m_clause_start[clause + 1]; i++) {
+        this->m_occurrences[next[this->m_literals[i]]++] = clause;
+      }
+    }
+
+    this->m_true_count = std::vector<int>(num_clauses, 0);
+    this->m_true_xor = std::vector<int>(num_clauses, 0);
+    this->m_unsatisfied_position = std::vector<int>(num_clauses, -1);
+    this->m_values = std::vector<char>(max_variable + 1, 0);
+    this->m_break_count = std::vector<int>(max_variable + 1, 0);
+
+    // A variable can break at most as many clauses as it occurs in
+    int max_occurrences = 0;
+    for (auto count : occurrences_count) {
+      max_occurrences = std::max(max_occurrences, count);
+    }
+
+    for (int breaks = 0; breaks <= max_occurrences; breaks++) {
+      this->m_break_score.push_back(std::pow(this->m_eps + breaks, -this->m_cb));
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Methods
+
+  // Runs local search starting from the given phases (variables without a
+  // phase start with a random value) for at most max_flips flips.
+  // Returns true if a satisfying assignment was found
+  bool search(Model phases, long max_flips) {
+    this->initialize(phases);
+    this->m_flips = 0;
+
+    while (!this->m_unsatisfied.empty() && this->m_flips < max_flips) {
+      int clause = this->m_unsatisfied[this->m_random() % this->m_unsatisfied.size()];
+
+      // Empty clauses can never be satisfied
+      if (this->m_clause_start[clause] == this->m_clause_start[clause + 1]) break;
+
+      int variable = this->m_algorithm == PROBSAT ? this->pickProbSAT(clause) : this->pickWalkSAT(clause);
+      this->flip(variable);
+      this->m_flips++;
+
+      if ((int) this->m_unsatisfied.size() < this->m_best_unsatisfied) {
+        this->m_best_unsatisfied = this->m_unsatisfied.size();
+        this->m_best_values = this->m_values;
+      }
+    }
+
+    return this->m_best_unsatisfied == 0;
+  }
+
+  // Best assignment found by the last search
+  Model getModel() {
+    Model model = Model();
+
+    for (auto variable : this->m_variables) {
+      model[variable] = this->m_best_values[variable];
+    }
+
+    return model;
+  }
+
+  int bestUnsatisfied() {
+    return this->m_best_unsatisfied;
+  }
+
+  long flips() {
+    return this->m_flips;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Private methods
+
+private:
+
+  int numClauses() {
+    return this->m_clause_start.size() - 1;
+  }
+
+  bool isTrue(int literal) {
+    return this->m_values[literal >> 1] != (literal & 1);
+  }
+
+  void initialize(Model &phases) {
+    for (auto variable : this->m_variables) {
+      auto phase = phases.find(variable);
+      this->m_values[variable] = phase != phases.end() ? phase->second : this->m_random() & 1;
+      this->m_break_count[variable] = 0;
+    }
+
+    this->m_unsatisfied.clear();
+
+    int num_clauses = this->numClauses();
+    for (int clause = 0; clause < num_clauses; clause++) {
+      this->m_true_count[clause] = 0;
+      this->m_true_xor[clause] = 0;
+      this->m_unsatisfied_position[clause] = -1;
+
+      for (int i = this->m_clause_start[clause]; i < this->m_clause_start[clause + 1]; i++) {
+        int literal = this->m_literals[i];
+
+        if (this->isTrue(literal)) {
+          this->m_true_count[clause]++;
+          this->m_true_xor[clause] ^= literal >> 1;
+        }
+      }
+
+      if (this->m_true_count[clause] == 0) {
+        this->addUnsatisfied(clause);
+      } else if (this->m_true_count[clause] == 1) {
+        this->m_break_count[this->m_true_xor[clause]]++;
+      }
+    }
+
+    this->m_best_unsatisfied = this->m_unsatisfied.size();
+    this->m_best_values = this->m_values;
+  }
+
+  void addUnsatisfied(int clause) {
+    this->m_unsatisfied_position[clause] = this->m_unsatisfied.size();
+    this->m_unsatisfied.push_back(clause);
+  }
+
+  void removeUnsatisfied(int clause) {
+    int position = this->m_unsatisfied_position[clause];
+    int last = this->m_unsatisfied.back();
+
+    this->m_unsatisfied[position] = last;
+    this->m_unsatisfied_position[last] = position;
+    this->m_unsatisfied.pop_back();
+    this->m_unsatisfied_position[clause] = -1;
+  }
+
+  // Flips a variable, updating true counts, break counts and the list of
+  // unsatisfied clauses incrementally
+  void flip(int variable) {
+    this->m_values[variable] = !this->m_values[variable];
+
+    int made_true = 2 * variable + !this->m_values[variable];
+    int made_false = made_true ^ 1;
+
+    for (int i = this->m_occurrence_start[made_false]; i < this->m_occurrence_start[made_false + 1]; i++) {
+      int clause = this->m_occurrences[i];
+      int count = --this->m_true_count[clause];
+      this->m_true_xor[clause] ^= variable;
+
+      if (count == 0) {
+        this->addUnsatisfied(clause);
+        this->m_break_count[variable]--;
+      } else if (count == 1) {
+        this->m_break_count[this->m_true_xor[clause]]++;
+      }
+    }
+
+    for (int i = this->m_occurrence_start[made_true]; i < this->m_occurrence_start[made_true + 1]; i++) {
+      int clause = this->m_occurrences[i];
+      int count = ++this->m_true_count[clause];
+      this->m_true_xor[clause] ^= variable;
+
+      if (count == 1) {
+        this->removeUnsatisfied(clause);
+        this->m_break_count[variable]++;
+      } else if (count == 2) {
+        this->m_break_count[this->m_true_xor[clause] ^ variable]--;
+      }
+    }
+  }
+
+  // ProbSAT: pick a variable of the clause with probability proportional to
+  // (eps + break)^-cb
+  int pickProbSAT(int clause) {
+    int start = this->m_clause_start[clause];
+    int end = this->m_clause_start[clause + 1];
+    double total = 0;
+
+    this->m_probabilities.clear();
+    for (int i = start; i < end; i++) {
+      double score = this->m_break_score[this->m_break_count[this->m_literals[i] >> 1]];
+      this->m_probabilities.push_back(score);
+      total += score;
+    }
+
+    double threshold = std::uniform_real_distribution<double>(0, total)(this->m_random);
+    for (int i = start; i < end; i++) {
+      threshold -= this->m_probabilities[i - start];
+      if (threshold <= 0) return this->m_literals[i] >> 1;
+    }
+
+    return this->m_literals[end - 1] >> 1;
+  }
+
+  // WalkSAT/SKC: flip a variable that breaks nothing if possible, otherwise
+  // a random one with probability noise, otherwise one with minimum break
+  int pickWalkSAT(int clause) {
+    int start = this->m_clause_start[clause];
+    int end = this->m_clause_start[clause + 1];
+
+    int best_variable = this->m_literals[start] >> 1;
+    int best_break = this->m_break_count[best_variable];
+    for (int i = start + 1; i < end && best_break > 0; i++) {
+      int variable = this->m_literals[i] >> 1;
+
+      if (this->m_break_count[variable] < best_break) {
+        best_variable = variable;
+        best_break = this->m_break_count[variable];
+      }
+    }
+
+    if (best_break == 0) return best_variable;
+
+    if (std::uniform_real_distribution<double>(0, 1)(this->m_random) < this->m_noise) {
+      return this->m_literals[start + this->m_random() % (end - start)] >> 1;
+    }
+
+    return best_variable;
+  }
+
+};
+
+} // cdcl
\ No newline at end of file
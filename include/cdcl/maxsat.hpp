@@ -0,0 +1,248 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Headers
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional>
+
+#include <cdcl/weighted_formula.hpp>
+#include <cdcl/solver.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace cdcl {
+
+///////////////////////////////////////////////////////////////////////////////
+// Classes
+
+// Core-guided weighted partial MaxSAT solver implementing OLL with weight
+// stratification.
+//
+// Every soft clause C gets a relaxation variable r, C ∨ r becomes hard and
+// ¬r is a soft literal. Soft literals are passed as assumptions to a single
+// incremental Solver, so clauses learnt in one iteration are reused by the
+// following ones. Each core raises the lower bound by its minimum weight
+// and is relaxed with a totalizer whose outputs become new soft literals.
+class MaxSATSolver {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Members
+private:
+  WeightedFormula m_formula;
+  std::optional<Solver> m_solver;
+  std::set<int> m_variables;
+  int m_next_variable;
+
+  // Soft literals and their remaining weight
+  std::map<Literal, long> m_soft;
+
+  // Outputs o_1, ..., o_n of each totalizer (o_k: at least k inputs are true)
+  // and, for every output used as soft literal ¬o_k, its totalizer and k
+  std::vector<std::vector<Literal>> m_totalizers;
+  std::unordered_map<int, std::pair<int, int>> m_totalizer_outputs;
+
+  long m_lower_bound;
+  long m_best_cost;
+  Model m_best_model;
+  long m_cores;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Constructors
+
+public:
+
+  MaxSATSolver (WeightedFormula &formula) {
+    this->m_formula = formula;
+    this->m_lower_bound = 0;
+    this->m_best_cost = -1;
+    this->m_best_model = Model();
+    this->m_cores = 0;
+
+    this->m_variables = formula.hard().variables();
+    for (auto &clause : formula.softClauses()) {
+      for (auto literal : clause.literals()) {
+        this->m_variables.insert(literal.variable());
+      }
+    }
+
+    this->m_next_variable = this->m_variables.empty() ? 1 : *this->m_variables.rbegin() + 1;
+
+    Formula hard = formula.hard();
+    for (int i = 0; i < (int) formula.softClauses().size(); i++) {
+      int relaxation = this->newVariable();
+
+      std::set<Literal> literals = formula.softClauses()[i].literals();
+      literals.insert(Literal(relaxation));
+
+      Clause relaxed = Clause(literals);
+      hard.addClause(relaxed);
+      this->m_soft[Literal(relaxation, true)] += formula.weights()[i];
+    }
+
+    this->m_solver = Solver(hard);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Methods
+
+  // Returns the optimal cost, or -1 if the hard clauses are unsatisfiable.
+  // callback is called with the cost and the model of every improving
+  // solution
+  long solve(std::function<void(long, Model&)> callback = nullptr) {
+    long threshold = 0;
+    for (auto &soft : this->m_soft) {
+      threshold = std::max(threshold, soft.second);
+    }
+
+    while (true) {
+      std::vector<Literal> assumptions = std::vector<Literal>();
+      for (auto &soft : this->m_soft) {
+        if (soft.second >= threshold) assumptions.push_back(soft.first);
+      }
+
+      if (this->m_solver->solve(assumptions)) {
+        this->updateBest(callback);
+        if (this->m_best_cost == this->m_lower_bound) return this->m_best_cost;
+
+        // Move to the next weight stratum
+        long next_threshold = 0;
+        for (auto &soft : this->m_soft) {
+          if (soft.second < threshold) next_threshold = std::max(next_threshold, soft.second);
+        }
+
+        if (next_threshold == 0) return this->m_best_cost;
+        threshold = next_threshold;
+
+        continue;
+      }
+
+      std::vector<Literal> core = this->m_solver->core();
+
+      // Unsatisfiable without assumptions: the hard clauses are
+      if (core.empty()) return this->m_best_cost;
+
+      this->relaxCore(core);
+    }
+  }
+
+  Model getModel() {
+    return this->m_best_model;
+  }
+
+  long lowerBound() {
+    return this->m_lower_bound;
+  }
+
+  long cores() {
+    return this->m_cores;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Private methods
+
+private:
+
+  int newVariable() {
+    return this->m_next_variable++;
+  }
+
+  void updateBest(std::function<void(long, Model&)> &callback) {
+    Model model = this->m_solver->getModel();
+    long cost = this->m_formula.cost(model);
+
+    if (this->m_best_cost >= 0 && cost >= this->m_best_cost) return;
+
+    this->m_best_cost = cost;
+    this->m_best_model = Model();
+    for (auto variable : this->m_variables) {
+      this->m_best_model[variable] = model[variable];
+    }
+
+    if (callback) {
+      callback(this->m_best_cost, this->m_best_model);
+    }
+  }
+
+  // OLL: the core costs at least its minimum weight. That weight is moved
+  // from the core literals to a totalizer over their negations, whose
+  // output ¬o_2 becomes soft: violating a second literal of the core costs
+  // again. Outputs ¬o_k appearing in a core are extended with ¬o_(k + 1)
+  void relaxCore(std::vector<Literal> &core) {
+    this->m_cores++;
+
+    long weight = -1;
+    for (auto &literal : core) {
+      long soft_weight = this->m_soft[literal];
+      weight = weight < 0 ? soft_weight : std::min(weight, soft_weight);
+    }
+
+    this->m_lower_bound += weight;
+
+    for (auto &literal : core) {
+      this->m_soft[literal] -= weight;
+      if (this->m_soft[literal] == 0) this->m_soft.erase(literal);
+
+      auto output = this->m_totalizer_outputs.find(literal.variable());
+      if (output == this->m_totalizer_outputs.end()) continue;
+
+      int totalizer = output->second.first;
+      int k = output->second.second;
+      if (k < (int) this->m_totalizers[totalizer].size()) {
+        this->addSoftOutput(totalizer, k + 1, weight);
+      }
+    }
+
+    if (core.size() == 1) return;
+
+    std::vector<Literal> inputs = std::vector<Literal>();
+    for (auto &literal : core) {
+      inputs.push_back(Literal(literal.variable(), !literal.negated()));
+    }
+
+    this->m_totalizers.push_back(this->buildTotalizer(inputs, 0, inputs.size()));
+    this->addSoftOutput(this->m_totalizers.size() - 1, 2, weight);
+  }
+
+  void addSoftOutput(int totalizer, int k, long weight) {
+    Literal output = this->m_totalizers[totalizer][k - 1];
+
+    this->m_soft[Literal(output.variable(), true)] += weight;
+    this->m_totalizer_outputs[output.variable()] = std::make_pair(totalizer, k);
+  }
+
+  // Totalizer encoding (Bailleux & Boufkhad, 2003) of inputs[begin .. end).
+  // Only the clauses forcing the outputs up are needed
+  std::vector<Literal> buildTotalizer(std::vector<Literal> &inputs, int begin, int end) {
+    if (end - begin == 1) return std::vector<Literal>({inputs[begin]});
+
+    int middle = (begin + end) / 2;
+    std::vector<Literal> left = this->buildTotalizer(inputs, begin, middle);
+    std::vector<Literal> right = this->buildTotalizer(inputs, middle, end);
+
+    std::vector<Literal> outputs = std::vector<Literal>();
+    for (int i = begin; i < end; i++) {
+      outputs.push_back(Literal(this->newVariable()));
+    }
+
+    for (int a = 0; a <= (int) left.size(); a++) {
+      for (int b = 0; b <= (int) right.size(); b++) {
+        if (a + b == 0) continue;
+
+        std::vector<Literal> literals = std::vector<Literal>({outputs[a + b - 1]});
+        if (a > 0) literals.push_back(Literal(left[a - 1].variable(), !left[a - 1].negated()));
+        if (b > 0) literals.push_back(Literal(right[b - 1].variable(), !right[b - 1].negated()));
+
+        Clause clause = Clause(literals);
+        this->m_solver->addClause(clause);
+      }
+    }
+
+    return outputs;
+  }
+
+};
+
+} // cdcl
\ No newline at end of file
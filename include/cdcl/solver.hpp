@@ -3,9 +3,15 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Headers
 #include <algorithm>
+#include <functional>
+#include <unordered_set>
+#include <map>
 
 #include <cdcl/formula.hpp>
 #include <cdcl/assignment.hpp>
+#include <cdcl/local_search.hpp>
+#include <cdcl/gauss.hpp>
+#include <cdcl/cardinality_propagator.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Namespace
@@ -32,7 +38,19 @@ typedef struct {
 
 typedef std::pair<ClauseStatus, std::optional<Literal>> ClauseStatusWithUnitLiteral;
 typedef std::pair<int, bool> LiteralAssignment;
-typedef std::pair<int, std::optional<Clause>> ConflictAnalysisResult;
+
+typedef struct {
+  bool unsatisfiable;
+  int backtrack_level;
+  // std::nullopt when the conflict only requires backtracking
+  std::optional<Clause> learnt_clause;
+} ConflictAnalysisResult;
+
+typedef struct {
+  // Number of distinct decision levels of the clause when it was learnt
+  int lbd;
+  bool vivified;
+} LearntClause;
 
 ///////////////////////////////////////////////////////////////////////////////
 // Classes
@@ -45,6 +63,56 @@ private:
   Formula m_formula;
   PartialAssignment m_assignment;
 
+  // Gauss-Jordan elimination over the XOR constraints, if any
+  std::optional<GaussJordan> m_gauss;
+
+  // Counter based propagation of the cardinality constraints, if any
+  std::optional<CardinalityPropagator> m_cardinality;
+
+  // Last value assigned to each variable, used as decision polarity
+  std::unordered_map<int, bool> m_phases;
+
+  // Variables to branch on first, used by model enumeration
+  std::set<int> m_projection;
+
+  // Literals decided first, one per decision level, and the subset of them
+  // responsible for unsatisfiability
+  std::vector<Literal> m_assumptions;
+  std::vector<Literal> m_core;
+
+  // Rephasing with local search
+  std::optional<LocalSearch> m_local_search;
+  bool m_local_search_rephasing;
+  LocalSearchAlgorithm m_local_search_algorithm;
+  long m_local_search_flips;
+  int m_rephase_interval;
+  int m_next_rephase;
+  int m_rephases;
+
+  // Chronological backtracking: when the backjump would skip more than this
+  // many levels, backtrack a single level instead (-1 = disabled)
+  int m_chrono_threshold;
+
+  // Learnt clauses, which are also part of the formula
+  std::map<Clause, LearntClause> m_learnts;
+
+  // Vivification of the clauses, every m_vivify_interval * k conflicts
+  // (-1 = disabled). Its budget is measured in ticks, the clauses visited by
+  // unit propagation
+  int m_vivify_interval;
+  long m_next_vivification;
+  int m_vivifications;
+  long m_ticks;
+  long m_ticks_at_vivification;
+  int m_irredundant_cursor;
+
+  // Statistics
+  long m_conflicts;
+  long m_decisions;
+  long m_propagations;
+  long m_vivified_literals;
+  long m_vivified_clauses;
+
   /////////////////////////////////////////////////////////////////////////////
   // Constructors
 
@@ -53,57 +121,503 @@ public:
   Solver (Formula &formula) {
     this->m_formula = formula;
     this->m_assignment = PartialAssignment();
+    this->m_gauss = std::nullopt;
+    this->m_cardinality = std::nullopt;
+    this->m_phases = std::unordered_map<int, bool>();
+    this->m_projection = std::set<int>();
+    this->m_assumptions = std::vector<Literal>();
+    this->m_core = std::vector<Literal>();
+    this->m_local_search = std::nullopt;
+    this->m_local_search_rephasing = false;
+    this->m_local_search_algorithm = LocalSearchAlgorithm::PROBSAT;
+    this->m_local_search_flips = 100000;
+    this->m_rephase_interval = 100;
+    this->m_next_rephase = 0;
+    this->m_rephases = 0;
+    this->m_chrono_threshold = -1;
+    this->m_learnts = std::map<Clause, LearntClause>();
+    this->m_vivify_interval = -1;
+    this->m_next_vivification = 0;
+    this->m_vivifications = 0;
+    this->m_ticks = 0;
+    this->m_ticks_at_vivification = 0;
+    this->m_irredundant_cursor = 0;
+    this->m_conflicts = 0;
+    this->m_decisions = 0;
+    this->m_propagations = 0;
+    this->m_vivified_literals = 0;
+    this->m_vivified_clauses = 0;
   }
 
   /////////////////////////////////////////////////////////////////////////////
   // Methods
 
-  bool solve() {
-    this->m_assignment.clear();
+  // Every rephase_interval * k conflicts (k = 1, 2, ...) the solver runs
+  // local search seeded with the saved phases, takes its best assignment as
+  // the new phases and restarts
+  void setLocalSearchRephasing(LocalSearchAlgorithm algorithm, long max_flips = 100000, int rephase_interval = 100) {
+    this->m_local_search_rephasing = true;
+    this->m_local_search_algorithm = algorithm;
+    this->m_local_search_flips = max_flips;
+    this->m_rephase_interval = rephase_interval;
+  }
 
-    // Assign initial values
-    UnitPropagationResult result = this->unitPropagate();
-    if (result.status == ClauseStatus::CONFLICT) {
-      return false;
+  // Following Nadel & Ryvchin, backtrack chronologically (one level) instead
+  // of backjumping when the backjump distance exceeds the threshold.
+  // A negative threshold disables chronological backtracking
+  void setChronologicalBacktracking(int threshold) {
+    this->m_chrono_threshold = threshold;
+  }
+
+  // Every vivify_interval * k conflicts (k = 1, 2, ...) the solver restarts
+  // and vivifies its learnt clauses, then a slice of the irredundant ones.
+  // A negative interval disables vivification
+  void setVivification(int vivify_interval) {
+    this->m_vivify_interval = vivify_interval;
+  }
+
+  // Solves the formula under the given assumptions. If it is unsatisfiable,
+  // core() returns the assumptions it is unsatisfiable with. Clauses learnt
+  // by previous calls are kept
+  bool solve(std::vector<Literal> assumptions = std::vector<Literal>()) {
+    this->m_assumptions = assumptions;
+    this->m_core.clear();
+
+    if (!this->initialize()) return false;
+
+    return this->search();
+  }
+
+  std::vector<Literal> core() {
+    return this->m_core;
+  }
+
+  // Adds a clause between two calls to solve()
+  void addClause(Clause &clause) {
+    this->m_formula.addClause(clause);
+  }
+
+  // Enumerates the models of the formula projected onto the given variables
+  // (all of them if empty), calling callback with each one until it returns
+  // false or limit models (if not negative) are found. The callback can be
+  // empty to only count models. Returns the number of models found.
+  //
+  // Learnt clauses and the trail are kept between models: projection
+  // variables are branched on first and each model is blocked by the
+  // negation of its projection decisions only, the other projection
+  // literals being implied by them. Blocking clauses stay in the formula
+  long enumerate(std::set<int> projection, std::function<bool(Model&)> callback, long limit = -1) {
+    this->m_projection = std::set<int>();
+    for (auto variable : projection.empty() ? this->m_formula.variables() : projection) {
+      if (this->m_formula.variables().count(variable)) this->m_projection.insert(variable);
     }
-    // Solve loop
-    while(! this->allVariablesAssigned()) {
-      LiteralAssignment branch_var = this->branch();
-      this->m_assignment.setDecisionLevel(this->m_assignment.decisionLevel() + 1);
-      this->m_assignment.assign(branch_var.first, branch_var.second, std::nullopt);
-      while(true) {
-        UnitPropagationResult unit_result = this->unitPropagate();
-        if (unit_result.status != ClauseStatus::CONFLICT) break;
 
-        ConflictAnalysisResult conflict_result = this->conflictAnalysis(unit_result.conflict_clause.value());
-        if (conflict_result.first < 0) return false;
+    long models = 0;
+    this->m_assumptions.clear();
+    bool satisfiable = this->initialize();
+
+    while (satisfiable && (limit < 0 || models < limit) && this->search()) {
+      models++;
+
+      if (callback) {
+        Model full_model = this->m_assignment.getModel();
+        Model model = Model();
+        for (auto variable : this->m_projection) {
+          model[variable] = full_model[variable];
+        }
 
-        this->m_formula.addClause(conflict_result.second.value());
-        this->m_assignment.backtrack(conflict_result.first);
-        this->m_assignment.setDecisionLevel(conflict_result.first);
+        if (!callback(model)) break;
       }
+
+      satisfiable = this->blockModel();
     }
 
-    return true;
+    this->m_projection.clear();
+
+    return models;
   }
 
   Model getModel() {
     return this->m_assignment.getModel();
   }
 
+  long conflicts() {
+    return this->m_conflicts;
+  }
+
+  long decisions() {
+    return this->m_decisions;
+  }
+
+  long propagations() {
+    return this->m_propagations;
+  }
+
+  // Literals removed and clauses deleted by vivification
+  long vivifiedLiterals() {
+    return this->m_vivified_literals;
+  }
+
+  long vivifiedClauses() {
+    return this->m_vivified_clauses;
+  }
+
   /////////////////////////////////////////////////////////////////////////////
   // Private methods
 
 private:
 
+  // Resets the search state. Returns false if the formula is trivially
+  // unsatisfiable
+  bool initialize() {
+    this->m_assignment.clear();
+    this->m_conflicts = 0;
+    this->m_decisions = 0;
+    this->m_propagations = 0;
+    this->m_vivified_literals = 0;
+    this->m_vivified_clauses = 0;
+    this->m_rephases = 0;
+    this->m_next_rephase = this->m_rephase_interval;
+    this->m_vivifications = 0;
+    this->m_next_vivification = this->m_vivify_interval;
+    this->m_ticks = 0;
+    this->m_ticks_at_vivification = 0;
+
+    this->m_local_search = std::nullopt;
+    if (this->m_local_search_rephasing) {
+      Formula clausal = this->m_formula.encodeCardinalities();
+      this->m_local_search = LocalSearch(clausal, this->m_local_search_algorithm);
+    }
+
+    this->m_gauss = std::nullopt;
+    if (!this->m_formula.xors().empty()) {
+      this->m_gauss = GaussJordan(this->m_formula.xors());
+      if (this->m_gauss->inconsistent()) return false;
+    }
+
+    this->m_cardinality = std::nullopt;
+    if (!this->m_formula.cardinalities().empty()) {
+      this->m_cardinality = CardinalityPropagator(this->m_formula.cardinalities());
+    }
+
+    return true;
+  }
+
+  // CDCL loop, resumed from the current trail. Returns true when every
+  // variable is assigned and false when the formula is unsatisfiable
+  bool search() {
+    while (true) {
+      UnitPropagationResult unit_result = this->unitPropagate();
+
+      if (unit_result.status == ClauseStatus::CONFLICT) {
+        ConflictAnalysisResult conflict_result = this->conflictAnalysis(unit_result.conflict_clause.value());
+        if (conflict_result.unsatisfiable) return false;
+        this->m_conflicts++;
+
+        if (conflict_result.learnt_clause.has_value()) {
+          Clause &learnt_clause = conflict_result.learnt_clause.value();
+
+          this->m_learnts[learnt_clause] = LearntClause({this->lbd(learnt_clause), false});
+          this->m_formula.addClause(learnt_clause);
+        }
+
+        this->backtrack(conflict_result.backtrack_level);
+        continue;
+      }
+
+      // Assumptions are decided first, one per level. An assumption that is
+      // already true gets an empty level, a false one ends the search
+      int next_level = this->m_assignment.decisionLevel() + 1;
+      if (next_level < (int) this->m_assumptions.size()) {
+        Literal assumption = this->m_assumptions[next_level];
+        this->m_assignment.setDecisionLevel(next_level);
+
+        if (!this->m_assignment.isAssigned(assumption.variable())) {
+          this->assign(assumption.variable(), !assumption.negated(), std::nullopt);
+          this->m_decisions++;
+        } else if (!this->m_assignment.value(assumption)) {
+          this->m_core = this->analyzeFinal(assumption);
+          return false;
+        }
+
+        continue;
+      }
+
+      if (this->allVariablesAssigned()) return true;
+
+      if (this->m_local_search.has_value() && this->m_conflicts >= this->m_next_rephase) {
+        this->rephase(this->m_local_search.value());
+
+        // Restart from the root level
+        this->backtrack(-1);
+        continue;
+      }
+
+      if (this->m_vivify_interval > 0 && this->m_conflicts >= this->m_next_vivification) {
+        // A conflict at the root level makes the formula unsatisfiable
+        this->backtrack(-1);
+        if (!this->vivify()) return false;
+
+        continue;
+      }
+
+      LiteralAssignment branch_var = this->branch();
+      this->m_assignment.setDecisionLevel(this->m_assignment.decisionLevel() + 1);
+      this->assign(branch_var.first, branch_var.second, std::nullopt);
+      this->m_decisions++;
+    }
+  }
+
+  // Blocks the projection of the current model, keeping the trail below the
+  // last projection decision. Returns false if no other model exists
+  bool blockModel() {
+    std::vector<Literal> blocking_literals = std::vector<Literal>();
+    int last_level = -1;
+
+    for (auto variable : this->m_assignment.trail()) {
+      if (!this->m_projection.count(variable) || !this->isDecision(variable)) continue;
+
+      Literal literal = Literal(variable);
+      blocking_literals.push_back(Literal(variable, this->m_assignment.value(literal)));
+      last_level = std::max(last_level, this->m_assignment.level(variable));
+    }
+
+    // The projection is implied at the root level
+    if (blocking_literals.empty()) return false;
+
+    Clause blocking_clause = Clause(blocking_literals);
+    this->m_formula.addClause(blocking_clause);
+    this->backtrack(last_level - 1);
+
+    return true;
+  }
+
+  // Assumptions implying the negation of a false assumption, found by
+  // walking the trail backwards through the reasons
+  std::vector<Literal> analyzeFinal(Literal &assumption) {
+    std::vector<Literal> core = std::vector<Literal>({assumption});
+    std::unordered_set<int> seen = std::unordered_set<int>({assumption.variable()});
+    std::vector<int> &trail = this->m_assignment.trail();
+
+    for (int i = trail.size() - 1; i >= 0; i--) {
+      int variable = trail[i];
+      if (!seen.count(variable) || this->m_assignment.level(variable) < 0) continue;
+
+      std::optional<Clause> reason = this->reason(variable);
+
+      // Only assumptions are decided at this point
+      if (!reason.has_value()) {
+        Literal literal = Literal(variable);
+        core.push_back(Literal(variable, !this->m_assignment.value(literal)));
+        continue;
+      }
+
+      for (auto literal : reason.value().literals()) {
+        seen.insert(literal.variable());
+      }
+    }
+
+    return core;
+  }
+
+  bool isDecision(int variable) {
+    if (this->m_assignment.antecedent(variable).has_value()) return false;
+    if (this->m_gauss.has_value() && this->m_gauss->hasReason(variable)) return false;
+    if (this->m_cardinality.has_value() && this->m_cardinality->hasReason(variable)) return false;
+
+    return true;
+  }
+
+  void assign(int variable, bool value, std::optional<Clause> antecedent) {
+    this->assign(variable, value, antecedent, this->m_assignment.decisionLevel());
+  }
+
+  void assign(int variable, bool value, std::optional<Clause> antecedent, int level) {
+    this->m_assignment.assign(variable, value, antecedent, level);
+    this->m_phases[variable] = value;
+  }
+
+  void backtrack(int level) {
+    this->m_assignment.backtrack(level);
+    this->m_assignment.setDecisionLevel(level);
+
+    if (this->m_gauss.has_value()) {
+      this->m_gauss->backtrack(this->m_assignment);
+    }
+
+    if (this->m_cardinality.has_value()) {
+      this->m_cardinality->backtrack(this->m_assignment);
+    }
+  }
+
+  // Antecedent of an implied variable. Implications of the Gauss-Jordan
+  // engine and of the cardinality propagator have no stored antecedent,
+  // their reason is computed on demand
+  std::optional<Clause> reason(int variable) {
+    std::optional<Clause> antecedent = this->m_assignment.antecedent(variable);
+    if (antecedent.has_value()) return antecedent;
+
+    if (this->m_gauss.has_value() && this->m_gauss->hasReason(variable)) {
+      return this->m_gauss->reason(variable, this->m_assignment);
+    }
+
+    if (this->m_cardinality.has_value() && this->m_cardinality->hasReason(variable)) {
+      return this->m_cardinality->reason(variable);
+    }
+
+    return antecedent;
+  }
+
+  void rephase(LocalSearch &local_search) {
+    local_search.search(this->m_phases, this->m_local_search_flips);
+    this->m_phases = local_search.getModel();
+
+    this->m_rephases++;
+    this->m_next_rephase = this->m_conflicts + (this->m_rephases + 1) * this->m_rephase_interval;
+  }
+
+  // Vivification at the root level. The negations of the literals of a
+  // clause are assigned one at a time and propagated without the clause:
+  // literals found false are removed, and a literal found true or a conflict
+  // make the remaining literals useless. A clause implied as a whole is
+  // deleted. Learnt clauses not vivified yet go first, by increasing LBD, then
+  // a slice of the irredundant clauses, until the tick budget is spent.
+  // Returns false if propagation gives a conflict at the root level
+  bool vivify() {
+    this->m_vivifications++;
+    this->m_next_vivification = this->m_conflicts + (this->m_vivifications + 1) * this->m_vivify_interval;
+
+    long clauses = this->m_formula.clauses().size();
+    long budget = std::max((this->m_ticks - this->m_ticks_at_vivification) / 10, 20 * clauses);
+    long ticks_limit = this->m_ticks + budget;
+
+    std::vector<Clause> candidates = std::vector<Clause>();
+    std::vector<Clause> irredundant = std::vector<Clause>();
+
+    for (auto &clause : this->m_formula.clauses()) {
+      auto learnt = this->m_learnts.find(clause);
+
+      if (learnt == this->m_learnts.end()) {
+        irredundant.push_back(clause);
+      } else if (!learnt->second.vivified) {
+        candidates.push_back(clause);
+      }
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [&](const Clause &a, const Clause &b) {
+      return this->m_learnts.at(a).lbd < this->m_learnts.at(b).lbd;
+    });
+
+    int slice = std::min((int) irredundant.size(), std::max(1, (int) irredundant.size() / 10));
+    for (int i = 0; i < slice; i++) {
+      candidates.push_back(irredundant[(this->m_irredundant_cursor + i) % irredundant.size()]);
+    }
+
+    this->m_irredundant_cursor = irredundant.empty() ? 0 : (this->m_irredundant_cursor + slice) % irredundant.size();
+
+    // Probing must not change the saved phases
+    std::unordered_map<int, bool> phases = this->m_phases;
+
+    bool consistent = this->unitPropagate().status != ClauseStatus::CONFLICT;
+    for (int i = 0; consistent && i < (int) candidates.size() && this->m_ticks < ticks_limit; i++) {
+      consistent = this->vivifyClause(candidates[i]);
+    }
+
+    this->m_phases = phases;
+    this->m_ticks_at_vivification = this->m_ticks;
+
+    return consistent;
+  }
+
+  // Returns false if propagating the vivified clause at the root level
+  // gives a conflict
+  bool vivifyClause(Clause &clause) {
+    // Already shortened into another candidate, or deleted
+    if (!this->m_formula.clauses().count(clause)) return true;
+
+    // A clause implying one of its literals at the root level is the only
+    // reason of that literal, the trail is cleared by the next solve()
+    for (auto literal : clause.literals()) {
+      if (!this->m_assignment.isAssigned(literal.variable()) || !this->m_assignment.value(literal)) continue;
+
+      std::optional<Clause> antecedent = this->m_assignment.antecedent(literal.variable());
+      if (antecedent.has_value() && antecedent.value() == clause) return true;
+    }
+
+    auto learnt = this->m_learnts.find(clause);
+    bool is_learnt = learnt != this->m_learnts.end();
+    int lbd = is_learnt ? learnt->second.lbd : 0;
+
+    this->m_formula.removeClause(clause);
+    if (is_learnt) this->m_learnts.erase(learnt);
+
+    std::vector<Literal> literals = std::vector<Literal>();
+    bool implied = false;
+
+    for (auto literal : clause.literals()) {
+      if (this->m_assignment.isAssigned(literal.variable())) {
+        if (!this->m_assignment.value(literal)) continue;
+
+        literals.push_back(literal);
+        implied = true;
+        break;
+      }
+
+      this->m_assignment.setDecisionLevel(this->m_assignment.decisionLevel() + 1);
+      this->assign(literal.variable(), literal.negated(), std::nullopt);
+      literals.push_back(literal);
+
+      if (this->unitPropagate().status == ClauseStatus::CONFLICT) {
+        implied = true;
+        break;
+      }
+    }
+
+    this->backtrack(-1);
+
+    // The other clauses imply it
+    if (implied && literals.size() == clause.literals().size()) {
+      this->m_vivified_clauses++;
+      return true;
+    }
+
+    // Every literal false at the root level cannot happen after propagation,
+    // keep the clause as it is
+    if (literals.empty()) {
+      std::set<Literal> clause_literals = clause.literals();
+      literals = std::vector<Literal>(clause_literals.begin(), clause_literals.end());
+    }
+
+    Clause vivified = Clause(literals);
+    this->m_vivified_literals += clause.literals().size() - literals.size();
+
+    if (is_learnt && !this->m_formula.clauses().count(vivified)) {
+      this->m_learnts[vivified] = LearntClause({std::min(lbd, (int) literals.size()), true});
+    }
+
+    this->m_formula.addClause(vivified);
+
+    return this->unitPropagate().status != ClauseStatus::CONFLICT;
+  }
+
+  // Number of distinct decision levels among the literals of the clause
+  int lbd(Clause &clause) {
+    std::set<int> levels = std::set<int>();
+
+    for (auto literal : clause.literals()) {
+      levels.insert(this->m_assignment.level(literal.variable()));
+    }
+
+    return levels.size();
+  }
+
   // Applies all unit propagations possible
   UnitPropagationResult unitPropagate() {
     bool can_unit = false;
-    int satisfied_clauses = 0;
 
     do {
       can_unit = false;
-      satisfied_clauses = 0;
+      this->m_ticks += this->m_formula.clauses().size();
 
       // For each clause, check its status
       // If it is unresolved or satisfied, we can ignore it
@@ -121,7 +635,8 @@ private:
         // status = UNIT -> apply unit propagation
         else if (status == ClauseStatus::UNIT) {
           Literal literal = literal_to_unit.value();
-          this->m_assignment.assign(literal.variable(), !literal.negated(), clause);
+          this->assign(literal.variable(), !literal.negated(), clause, this->impliedLevel(clause, literal.variable()));
+          this->m_propagations++;
           can_unit = true;
         }
 
@@ -130,6 +645,38 @@ private:
           return UnitPropagationResult({ClauseStatus::CONFLICT, std::nullopt, clause});
         }
       }
+
+      // Once clauses are done, propagate the XOR constraints
+      if (!can_unit && this->m_gauss.has_value()) {
+        std::vector<XorImplication> implications = std::vector<XorImplication>();
+        int conflict_row = this->m_gauss->propagate(this->m_assignment, implications);
+
+        for (auto &implication : implications) {
+          this->assign(implication.variable, implication.value, std::nullopt, implication.decision_level);
+          this->m_propagations++;
+          can_unit = true;
+        }
+
+        if (conflict_row >= 0) {
+          return UnitPropagationResult({ClauseStatus::CONFLICT, std::nullopt, this->m_gauss->conflictClause(conflict_row, this->m_assignment)});
+        }
+      }
+
+      // Then the cardinality constraints
+      if (!can_unit && this->m_cardinality.has_value()) {
+        std::vector<CardinalityImplication> implications = std::vector<CardinalityImplication>();
+        int conflict_constraint = this->m_cardinality->propagate(this->m_assignment, implications);
+
+        for (auto &implication : implications) {
+          this->assign(implication.variable, implication.value, std::nullopt, implication.decision_level);
+          this->m_propagations++;
+          can_unit = true;
+        }
+
+        if (conflict_constraint >= 0) {
+          return UnitPropagationResult({ClauseStatus::CONFLICT, std::nullopt, this->m_cardinality->conflictClause(conflict_constraint)});
+        }
+      }
     } while (can_unit);
 
     return UnitPropagationResult({ClauseStatus::UNRESOLVED, std::nullopt, std::nullopt});;
@@ -172,131 +719,144 @@ private:
     return std::make_pair(status, literal_to_unit);
   }
 
+  // Assumptions may assign variables outside the formula, so assigned
+  // variables cannot just be counted
   bool allVariablesAssigned() {
-    return this->m_formula.variables().size() == this->m_assignment.assignedVariables();
+    for (auto variable : this->m_formula.variables()) {
+      if (!this->m_assignment.isAssigned(variable)) return false;
+    }
+
+    return true;
   }
   
-  // Criterion: pick first unassigned variable and assign it to true
+  // Criterion: pick first unassigned variable, projection variables first,
+  // and assign it to its saved phase (true if it has never been assigned)
   LiteralAssignment branch() {
     int branch_var = -1;
-    for (auto &variable : this->m_formula.variables()) {
+    for (auto &variable : this->m_projection) {
       if (! this->m_assignment.isAssigned(variable)) {
         branch_var = variable;
         break;
       }
     }
 
-    return std::make_pair(branch_var, true);
-  }
-
-  Clause resolve(Clause &a, Clause &b, int resolvent) {
-    std::set<Literal> resolved;
-
-    std::set<Literal> clause_union;
-
-    for (auto &literal : a.literals()) {
-      resolved.insert(literal);
-    }
+    for (auto &variable : this->m_formula.variables()) {
+      if (branch_var != -1) break;
 
-    for (auto &literal : b.literals()) {
-      resolved.insert(literal);
+      if (! this->m_assignment.isAssigned(variable)) {
+        branch_var = variable;
+        break;
+      }
     }
 
-    resolved.erase(Literal(resolvent, true));
-    resolved.erase(Literal(resolvent, false));
+    auto phase = this->m_phases.find(branch_var);
+    bool value = phase != this->m_phases.end() ? phase->second : true;
 
-    return Clause(resolved);
+    return std::make_pair(branch_var, value);
   }
 
-  int hasResolvent(Clause &a, Clause &b) {
-    int resolvent = -1;
-    std::set<Literal> clause_union;
+  // An implied literal belongs to the highest level among the other (false)
+  // literals of its antecedent, which can be lower than the current level
+  // after chronological backtracking
+  int impliedLevel(Clause &clause, int variable) {
+    int level = -1;
 
-    for (auto &literal : a.literals()) {
-      clause_union.insert(literal);
+    for (auto literal : clause.literals()) {
+      if (literal.variable() != variable) {
+        level = std::max(level, this->m_assignment.level(literal.variable()));
+      }
     }
 
-    for (auto &literal : b.literals()) {
-      clause_union.insert(literal);
-    }
+    return level;
+  }
+
+  // First UIP conflict analysis over the trail. The conflict is analyzed at
+  // the highest level among the literals of the conflict clause, which after
+  // chronological backtracking can be lower than the current decision level
+  ConflictAnalysisResult conflictAnalysis(Clause &conflict_clause) {
+    int conflict_level = -1;
+    int literals_at_conflict_level = 0;
 
-    for (auto literal : clause_union) {
-      bool contains_literal = clause_union.find(Literal(literal.variable(), false)) != clause_union.end();
-      bool contains_negated = clause_union.find(Literal(literal.variable(), true)) != clause_union.end();
+    for (auto literal : conflict_clause.literals()) {
+      int level = this->m_assignment.level(literal.variable());
 
-      if (contains_negated && contains_literal) {
-        return literal.variable();
+      if (level > conflict_level) {
+        conflict_level = level;
+        literals_at_conflict_level = 1;
+      } else if (level == conflict_level) {
+        literals_at_conflict_level++;
       }
     }
 
-    return resolvent;
-  }
+    if (conflict_level < 0) return ConflictAnalysisResult({true, -1, std::nullopt});
 
-  ConflictAnalysisResult conflictAnalysis(Clause &conflict_clause) {
-    if (this->m_assignment.decisionLevel() == 0) return std::make_pair(-1, std::nullopt);
+    // A single literal at the conflict level: the clause becomes unit (an
+    // implication missed because of out of order levels) once that level is
+    // undone, so there is nothing to learn
+    if (literals_at_conflict_level == 1) {
+      return ConflictAnalysisResult({false, conflict_level - 1, std::nullopt});
+    }
 
-    auto assignments_at_level = this->m_assignment.getLiteralsAtCurrentDecisionLevel();
+    // Undo the levels above the conflict level, so that every literal left
+    // on the trail has a level lower or equal to it
+    this->backtrack(conflict_level);
 
-    Clause learnt_clause = conflict_clause;
-    int dl_to_backtrack_to = 0;
+    std::unordered_set<int> seen = std::unordered_set<int>();
+    std::vector<Literal> learnt_literals = std::vector<Literal>();
+    int open_literals = 0;
 
-    while (assignments_at_level.size() != 1) {
-      // Pick first clause that has a resolvent
-      std::set<Literal> learnt_clause_literals = learnt_clause.literals();
+    std::optional<Clause> reason = conflict_clause;
+    std::vector<int> &trail = this->m_assignment.trail();
+    int trail_index = trail.size() - 1;
+    int uip = -1;
 
-      // Look for a resolvent and eventually resolve
-      auto literals_at_dl = assignments_at_level.begin();
-      while (literals_at_dl != assignments_at_level.end()) {
-        int resolvent = hasResolvent(learnt_clause, literals_at_dl->second.antecedent.value());
-        if (resolvent == -1) {
-          literals_at_dl++;
-          continue;
-        };
+    while (true) {
+      for (auto literal : reason.value().literals()) {
+        int variable = literal.variable();
+        int level = this->m_assignment.level(variable);
 
-        // Resolve
-        learnt_clause = this->resolve(learnt_clause, literals_at_dl->second.antecedent.value(), resolvent);
-        literals_at_dl = assignments_at_level.erase(literals_at_dl);
-      }
+        // Root level literals are false in every model, skip them
+        if (variable == uip || seen.count(variable) || level < 0) continue;
+        seen.insert(variable);
 
-    }
+        if (level == conflict_level) {
+          open_literals++;
+        } else {
+          learnt_literals.push_back(literal);
+        }
+      }
 
-    // Learnt clause is now final, according to 1° UIP rule
+      // Next literal of the conflict level to resolve on. Literals of lower
+      // levels may be interleaved on the trail
+      while (!seen.count(trail[trail_index]) || this->m_assignment.level(trail[trail_index]) != conflict_level) {
+        trail_index--;
+      }
 
-    // Backtrack to the highest branching point s.t. the stack contains all-but-one
-    // literals in the conflict set, and then unit-propagate the unassigned literal 
-    // on the learnt clause
+      uip = trail[trail_index--];
+      open_literals--;
 
-    std::set<Literal> conflict_set = std::set<Literal>();
-    for (auto literal : learnt_clause.literals()) {
-      conflict_set.insert(Literal(literal.variable(), !literal.negated()));
-    } 
+      if (open_literals == 0) break;
 
-    int current_dl_in_search = 0;
-    while (current_dl_in_search < this->m_assignment.decisionLevel()) {
-      assignments_at_level = this->m_assignment.getLiteralsAtDecisionLevel(current_dl_in_search, false);
+      reason = this->reason(uip);
+    }
 
-      // Do they differ by only one literal?
-      int difference = 0;
-      for (auto &literal : assignments_at_level) {
-        // We don't really care about the polarity of the literal
-        bool contains_literal = conflict_set.find(Literal(literal.first, true)) != conflict_set.end();
-        contains_literal = contains_literal || (conflict_set.find(Literal(literal.first, false)) != conflict_set.end());
-        
-        if (! contains_literal) {
-          difference++;
-        }
-      }
+    // The negation of the UIP becomes the asserting literal
+    Literal uip_literal = Literal(uip);
+    learnt_literals.push_back(Literal(uip, this->m_assignment.value(uip_literal)));
 
-      // Is this a candidate dl?
-      if (difference == 1) {
-        dl_to_backtrack_to = current_dl_in_search;
-        break;
+    int backjump_level = -1;
+    for (auto &literal : learnt_literals) {
+      if (literal.variable() != uip) {
+        backjump_level = std::max(backjump_level, this->m_assignment.level(literal.variable()));
       }
+    }
 
-      current_dl_in_search++;
+    int backtrack_level = backjump_level;
+    if (this->m_chrono_threshold >= 0 && conflict_level - backjump_level > this->m_chrono_threshold) {
+      backtrack_level = conflict_level - 1;
     }
 
-    return std::make_pair(dl_to_backtrack_to, learnt_clause);
+    return ConflictAnalysisResult({false, backtrack_level, Clause(learnt_literals)});
   }
 
 };
@@ -0,0 +1,532 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Headers
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <optional>
+
+#include <cdcl/formula.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace cdcl {
+
+///////////////////////////////////////////////////////////////////////////////
+// Types
+
+// Image of the positive literal of each variable moved by a symmetry
+typedef std::map<int, Literal> LiteralPermutation;
+
+// Ordered partition of the vertices. Cells are contiguous ranges of
+// elements and are identified by their first position
+typedef struct {
+  std::vector<int> elements;
+  // Position of each vertex in elements
+  std::vector<int> position;
+  // First position of the cell of each position
+  std::vector<int> cell;
+  // End of each cell, indexed by its first position
+  std::vector<int> cell_end;
+  int num_cells;
+} Partition;
+
+///////////////////////////////////////////////////////////////////////////////
+// Classes
+
+// Static symmetry breaking.
+//
+// The formula is turned into a colored graph with two vertices per variable
+// (its literals, joined by an edge) and one vertex per constraint, joined to
+// its literals. Automorphisms of the graph are symmetries of the formula.
+// Generators are found with a partition refinement search: the first path
+// of the search tree individualizes the first vertex of the first
+// non-singleton cell until the partition is discrete, then every other
+// vertex of those cells is individualized instead, looking for a leaf that
+// maps onto the first one. Since any set of symmetries can be broken
+// soundly, the search is bounded and needs not be complete.
+//
+// Partitions are refined to equitable ones by splitting cells: each cell
+// taken from a queue of splitters splits the cells of its neighbours by
+// their number of neighbours in it, and only the cells that split are
+// queued again. Each search node refines a copy of its parent.
+//
+// Every generator σ is broken by a lex-leader constraint x ≤lex σ(x) over
+// the variables it moves, ordered by index.
+class SymmetryBreaker {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Members
+private:
+  std::vector<int> m_variables;
+  std::unordered_map<int, int> m_variable_index;
+
+  // Vertex 2 * i is the positive literal of m_variables[i], 2 * i + 1 the
+  // negative one, constraint vertices follow
+  int m_num_vertices;
+  std::vector<std::vector<int>> m_adjacency;
+  std::vector<int> m_initial_colors;
+
+  // Vertices mapped onto each other by the generators found so far
+  std::vector<int> m_orbits;
+
+  std::vector<LiteralPermutation> m_generators;
+  long m_nodes;
+  long m_max_nodes;
+
+  // Refinement scratch space: neighbours of each vertex in the splitter,
+  // touched vertices of each cell and queued cells, by first position
+  std::vector<int> m_counts;
+  std::vector<int> m_touched_counts;
+  std::vector<char> m_queued;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Constructors
+
+public:
+
+  SymmetryBreaker (Formula &formula) {
+    this->m_nodes = 0;
+    this->m_max_nodes = 0;
+
+    for (auto variable : formula.variables()) {
+      this->m_variable_index[variable] = this->m_variables.size();
+      this->m_variables.push_back(variable);
+    }
+
+    // Colors are (kind, parameter) pairs, ranked once the graph is built
+    std::vector<std::pair<int, int>> colors = std::vector<std::pair<int, int>>();
+    for (int i = 0; i < (int) this->m_variables.size(); i++) {
+      colors.push_back(std::make_pair(0, 0));
+      colors.push_back(std::make_pair(0, 0));
+    }
+
+    this->m_adjacency = std::vector<std::vector<int>>(colors.size());
+    for (int i = 0; i < (int) this->m_variables.size(); i++) {
+      this->addEdge(2 * i, 2 * i + 1);
+    }
+
+    // Duplicated clauses would only add symmetries among themselves
+    std::set<std::set<Literal>> clauses = std::set<std::set<Literal>>();
+    for (auto clause : formula.clauses()) {
+      if (!clauses.insert(clause.literals()).second) continue;
+
+      int vertex = this->addVertex(colors, std::make_pair(1, 0));
+
+      for (auto literal : clause.literals()) {
+        this->addEdge(vertex, this->literalVertex(literal));
+      }
+    }
+
+    // XOR constraints are joined to positive literals only, so that no
+    // literal can be mapped onto a negative one and change the parity
+    for (auto &constraint : formula.xors()) {
+      int vertex = this->addVertex(colors, std::make_pair(2, constraint.rhs()));
+
+      for (auto variable : constraint.variables()) {
+        this->addEdge(vertex, this->literalVertex(Literal(variable)));
+      }
+    }
+
+    for (auto &constraint : formula.cardinalities()) {
+      int vertex = this->addVertex(colors, std::make_pair(3, constraint.bound()));
+
+      for (auto literal : constraint.literals()) {
+        this->addEdge(vertex, this->literalVertex(literal));
+      }
+    }
+
+    this->m_num_vertices = colors.size();
+    for (auto &neighbours : this->m_adjacency) {
+      std::sort(neighbours.begin(), neighbours.end());
+    }
+
+    std::vector<std::pair<int, int>> distinct_colors = colors;
+    std::sort(distinct_colors.begin(), distinct_colors.end());
+    distinct_colors.erase(std::unique(distinct_colors.begin(), distinct_colors.end()), distinct_colors.end());
+
+    for (auto &color : colors) {
+      this->m_initial_colors.push_back(std::lower_bound(distinct_colors.begin(), distinct_colors.end(), color) - distinct_colors.begin());
+    }
+
+    this->m_orbits = std::vector<int>(this->m_num_vertices);
+    std::iota(this->m_orbits.begin(), this->m_orbits.end(), 0);
+
+    this->m_counts = std::vector<int>(this->m_num_vertices, 0);
+    this->m_touched_counts = std::vector<int>(this->m_num_vertices, 0);
+    this->m_queued = std::vector<char>(this->m_num_vertices, 0);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Methods
+
+  // Searches generators of the automorphism group, refining at most
+  // max_nodes partitions. Returns the number of generators found
+  int findGenerators(long max_nodes = 10000) {
+    this->m_nodes = 0;
+    this->m_max_nodes = max_nodes;
+
+    // First path of the search tree
+    std::vector<Partition> path = std::vector<Partition>();
+    std::vector<int> chosen = std::vector<int>();
+    Partition partition = this->initialPartition();
+
+    while (!this->isDiscrete(partition)) {
+      int vertex = this->targetCell(partition)[0];
+
+      path.push_back(partition);
+      chosen.push_back(vertex);
+      this->individualize(partition, vertex);
+    }
+
+    path.push_back(partition);
+
+    // Other branches, deepest first
+    for (int level = chosen.size() - 1; level >= 0; level--) {
+      for (auto vertex : this->targetCell(path[level])) {
+        if (this->m_nodes >= this->m_max_nodes) return this->m_generators.size();
+        if (this->findOrbit(vertex) == this->findOrbit(chosen[level])) continue;
+
+        Partition branch = path[level];
+        this->individualize(branch, vertex);
+        this->search(branch, level + 1, path);
+      }
+    }
+
+    return this->m_generators.size();
+  }
+
+  std::vector<LiteralPermutation>& generators() {
+    return this->m_generators;
+  }
+
+  // Adds the lex-leader clauses of every generator to the formula, using at
+  // most size_limit variables per generator. Returns the number of clauses
+  int breakSymmetries(Formula &formula, int size_limit = 100) {
+    int next_variable = this->m_variables.empty() ? 1 : this->m_variables.back() + 1;
+    for (auto variable : formula.variables()) {
+      next_variable = std::max(next_variable, variable + 1);
+    }
+
+    int added = 0;
+    for (auto &generator : this->m_generators) {
+      // equal: the literals before the current one are equal to their image
+      std::optional<Literal> equal = std::nullopt;
+      int size = 0;
+
+      for (auto &image : generator) {
+        if (size++ >= size_limit) break;
+
+        Literal x = Literal(image.first);
+        Literal y = image.second;
+        Literal not_x = Literal(x.variable(), true);
+
+        // equal → (x → y)
+        std::vector<Literal> less = std::vector<Literal>({not_x, y});
+        if (equal.has_value()) less.push_back(Literal(equal->variable(), true));
+
+        Clause less_clause = Clause(less);
+        formula.addClause(less_clause);
+        added++;
+
+        if (size == size_limit || size == (int) generator.size()) break;
+
+        // equal ∧ (x = y) → next_equal
+        Literal next_equal = Literal(next_variable++);
+        std::vector<std::vector<Literal>> clauses = std::vector<std::vector<Literal>>({
+          std::vector<Literal>({not_x, next_equal}),
+          std::vector<Literal>({y, next_equal})
+        });
+
+        for (auto &literals : clauses) {
+          if (equal.has_value()) literals.push_back(Literal(equal->variable(), true));
+
+          Clause clause = Clause(literals);
+          formula.addClause(clause);
+          added++;
+        }
+
+        equal = next_equal;
+      }
+    }
+
+    return added;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Private methods
+
+private:
+
+  int literalVertex(Literal literal) {
+    return 2 * this->m_variable_index[literal.variable()] + literal.negated();
+  }
+
+  int addVertex(std::vector<std::pair<int, int>> &colors, std::pair<int, int> color) {
+    colors.push_back(color);
+    this->m_adjacency.push_back(std::vector<int>());
+
+    return colors.size() - 1;
+  }
+
+  void addEdge(int a, int b) {
+    this->m_adjacency[a].push_back(b);
+    this->m_adjacency[b].push_back(a);
+  }
+
+  bool hasEdge(int a, int b) {
+    return std::binary_search(this->m_adjacency[a].begin(), this->m_adjacency[a].end(), b);
+  }
+
+  // Cells of the initial colors, all of them queued as splitters
+  Partition initialPartition() {
+    Partition partition = Partition();
+    partition.elements = std::vector<int>(this->m_num_vertices);
+    std::iota(partition.elements.begin(), partition.elements.end(), 0);
+    std::stable_sort(partition.elements.begin(), partition.elements.end(), [&](int a, int b) {
+      return this->m_initial_colors[a] < this->m_initial_colors[b];
+    });
+
+    partition.position = std::vector<int>(this->m_num_vertices);
+    partition.cell = std::vector<int>(this->m_num_vertices);
+    partition.cell_end = std::vector<int>(this->m_num_vertices);
+    partition.num_cells = 0;
+
+    std::vector<int> splitters = std::vector<int>();
+    for (int i = 0; i < this->m_num_vertices; i++) {
+      int vertex = partition.elements[i];
+      partition.position[vertex] = i;
+
+      if (i == 0 || this->m_initial_colors[vertex] != this->m_initial_colors[partition.elements[i - 1]]) {
+        splitters.push_back(i);
+        partition.num_cells++;
+      }
+
+      partition.cell[i] = splitters.back();
+      partition.cell_end[splitters.back()] = i + 1;
+    }
+
+    this->refine(partition, splitters);
+
+    return partition;
+  }
+
+  // The vertex gets its own cell, right before the rest of its cell, and the
+  // partition is refined from it
+  void individualize(Partition &partition, int vertex) {
+    int position = partition.position[vertex];
+    int start = partition.cell[position];
+    int end = partition.cell_end[start];
+
+    this->swapElements(partition, position, start);
+
+    partition.cell_end[start] = start + 1;
+    partition.cell_end[start + 1] = end;
+    for (int i = start + 1; i < end; i++) {
+      partition.cell[i] = start + 1;
+    }
+
+    partition.num_cells++;
+
+    std::vector<int> splitters = std::vector<int>({start});
+    this->refine(partition, splitters);
+  }
+
+  // Equitable refinement. The result only depends on the graph and on the
+  // order of the splitters, so isomorphic nodes get isomorphic partitions
+  void refine(Partition &partition, std::vector<int> &splitters) {
+    this->m_nodes++;
+
+    for (auto splitter : splitters) {
+      this->m_queued[splitter] = 1;
+    }
+
+    std::vector<int> touched = std::vector<int>();
+    std::vector<int> touched_cells = std::vector<int>();
+
+    for (int head = 0; head < (int) splitters.size() && partition.num_cells < this->m_num_vertices; head++) {
+      int splitter = splitters[head];
+      this->m_queued[splitter] = 0;
+
+      for (int i = splitter; i < partition.cell_end[splitter]; i++) {
+        for (auto neighbour : this->m_adjacency[partition.elements[i]]) {
+          if (this->m_counts[neighbour]++ == 0) touched.push_back(neighbour);
+        }
+      }
+
+      // Touched vertices are moved to the end of their cell
+      for (auto vertex : touched) {
+        int cell = partition.cell[partition.position[vertex]];
+        int touched_count = this->m_touched_counts[cell]++;
+
+        if (touched_count == 0) touched_cells.push_back(cell);
+        this->swapElements(partition, partition.position[vertex], partition.cell_end[cell] - 1 - touched_count);
+      }
+
+      std::sort(touched_cells.begin(), touched_cells.end());
+      for (auto cell : touched_cells) {
+        this->split(partition, cell, splitters);
+      }
+
+      for (auto vertex : touched) {
+        this->m_counts[vertex] = 0;
+      }
+
+      touched.clear();
+      touched_cells.clear();
+    }
+
+    for (auto splitter : splitters) {
+      this->m_queued[splitter] = 0;
+    }
+  }
+
+  // Splits a cell whose touched vertices are at its end by their number of
+  // neighbours in the splitter, untouched vertices first. If the cell was
+  // queued, its new cells are queued too, otherwise all but the largest one
+  void split(Partition &partition, int start, std::vector<int> &splitters) {
+    int end = partition.cell_end[start];
+    int first_touched = end - this->m_touched_counts[start];
+    this->m_touched_counts[start] = 0;
+
+    std::sort(partition.elements.begin() + first_touched, partition.elements.begin() + end, [&](int a, int b) {
+      return this->m_counts[a] < this->m_counts[b];
+    });
+
+    std::vector<int> starts = std::vector<int>({start});
+    for (int i = first_touched; i < end; i++) {
+      int vertex = partition.elements[i];
+      partition.position[vertex] = i;
+
+      if (i > start && (i == first_touched || this->m_counts[vertex] != this->m_counts[partition.elements[i - 1]])) {
+        starts.push_back(i);
+      }
+    }
+
+    if (starts.size() == 1) return;
+
+    int largest = start;
+    for (int k = 0; k < (int) starts.size(); k++) {
+      int cell_end = k + 1 < (int) starts.size() ? starts[k + 1] : end;
+      partition.cell_end[starts[k]] = cell_end;
+
+      if (k > 0) {
+        for (int i = starts[k]; i < cell_end; i++) {
+          partition.cell[i] = starts[k];
+        }
+      }
+
+      if (cell_end - starts[k] > partition.cell_end[largest] - largest) largest = starts[k];
+    }
+
+    partition.num_cells += starts.size() - 1;
+
+    for (auto cell : starts) {
+      if (this->m_queued[cell] || (!this->m_queued[start] && cell == largest)) continue;
+
+      this->m_queued[cell] = 1;
+      splitters.push_back(cell);
+    }
+  }
+
+  void swapElements(Partition &partition, int a, int b) {
+    std::swap(partition.elements[a], partition.elements[b]);
+    partition.position[partition.elements[a]] = a;
+    partition.position[partition.elements[b]] = b;
+  }
+
+  bool isDiscrete(Partition &partition) {
+    return partition.num_cells == this->m_num_vertices;
+  }
+
+  // Vertices of the first cell with more than one vertex
+  std::vector<int> targetCell(Partition &partition) {
+    int start = 0;
+    while (start < this->m_num_vertices && partition.cell_end[start] - start == 1) {
+      start = partition.cell_end[start];
+    }
+
+    if (start == this->m_num_vertices) return std::vector<int>();
+
+    return std::vector<int>(partition.elements.begin() + start, partition.elements.begin() + partition.cell_end[start]);
+  }
+
+  // Nodes with different cells cannot lead to leaves mapped onto each other
+  bool sameCells(Partition &a, Partition &b) {
+    return a.num_cells == b.num_cells && a.cell == b.cell;
+  }
+
+  // Depth first search below a branch of the first path, pruning nodes
+  // whose cells differ from the first path. Returns true once a leaf gives
+  // an automorphism
+  bool search(Partition &partition, int level, std::vector<Partition> &path) {
+    if (!this->sameCells(partition, path[level])) return false;
+
+    if (this->isDiscrete(partition)) {
+      return this->addAutomorphism(path[level], partition);
+    }
+
+    for (auto vertex : this->targetCell(partition)) {
+      if (this->m_nodes >= this->m_max_nodes) return false;
+
+      Partition branch = partition;
+      this->individualize(branch, vertex);
+      if (this->search(branch, level + 1, path)) return true;
+    }
+
+    return false;
+  }
+
+  // The two leaves map vertices at the same position onto each other. If
+  // the mapping is an automorphism, it becomes a generator
+  bool addAutomorphism(Partition &first_leaf, Partition &leaf) {
+    std::vector<int> image = std::vector<int>(this->m_num_vertices);
+    for (int i = 0; i < this->m_num_vertices; i++) {
+      image[first_leaf.elements[i]] = leaf.elements[i];
+    }
+
+    for (int v = 0; v < this->m_num_vertices; v++) {
+      if (this->m_initial_colors[v] != this->m_initial_colors[image[v]]) return false;
+
+      for (auto neighbour : this->m_adjacency[v]) {
+        if (!this->hasEdge(image[v], image[neighbour])) return false;
+      }
+    }
+
+    LiteralPermutation generator = LiteralPermutation();
+    for (int i = 0; i < (int) this->m_variables.size(); i++) {
+      int target = image[2 * i];
+
+      if (target != 2 * i) {
+        generator.emplace(this->m_variables[i], Literal(this->m_variables[target / 2], target % 2));
+      }
+    }
+
+    for (int v = 0; v < this->m_num_vertices; v++) {
+      this->m_orbits[this->findOrbit(v)] = this->findOrbit(image[v]);
+    }
+
+    if (generator.empty()) return false;
+
+    this->m_generators.push_back(generator);
+
+    return true;
+  }
+
+  int findOrbit(int vertex) {
+    while (this->m_orbits[vertex] != vertex) {
+      this->m_orbits[vertex] = this->m_orbits[this->m_orbits[vertex]];
+      vertex = this->m_orbits[vertex];
+    }
+
+    return vertex;
+  }
+
+};
+
+} // cdcl
\ No newline at end of file
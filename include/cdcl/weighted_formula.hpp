@@ -0,0 +1,158 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Headers
+#include <iostream>
+#include <vector>
+#include <fstream>
+#include <string>
+
+#include <cdcl/formula.hpp>
+#include <cdcl/utils.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace cdcl {
+
+///////////////////////////////////////////////////////////////////////////////
+// Classes
+
+// Weighted partial MaxSAT instance: hard clauses that must be satisfied and
+// weighted soft clauses whose falsified weight is minimized
+class WeightedFormula {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Members
+private:
+  Formula m_hard;
+  std::vector<Clause> m_soft_clauses;
+  std::vector<long> m_weights;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Constructors
+
+public:
+
+  WeightedFormula () {
+    this->m_hard = Formula();
+    this->m_soft_clauses = std::vector<Clause>();
+    this->m_weights = std::vector<long>();
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Methods
+
+  Formula& hard() {
+    return this->m_hard;
+  }
+
+  std::vector<Clause>& softClauses() {
+    return this->m_soft_clauses;
+  }
+
+  std::vector<long>& weights() {
+    return this->m_weights;
+  }
+
+  void addHard(Clause &clause) {
+    this->m_hard.addClause(clause);
+  }
+
+  void addSoft(Clause &clause, long weight) {
+    this->m_soft_clauses.push_back(clause);
+    this->m_weights.push_back(weight);
+  }
+
+  // Sum of the weights of the soft clauses falsified by the model
+  long cost(Model &model) {
+    long cost = 0;
+
+    for (int i = 0; i < (int) this->m_soft_clauses.size(); i++) {
+      bool satisfied = false;
+
+      for (auto literal : this->m_soft_clauses[i].literals()) {
+        auto value = model.find(literal.variable());
+        if (value != model.end() && value->second != literal.negated()) {
+          satisfied = true;
+          break;
+        }
+      }
+
+      if (!satisfied) cost += this->m_weights[i];
+    }
+
+    return cost;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Static methods
+
+  // Reads both WCNF flavours: "p wcnf <variables> <clauses> <top>" followed
+  // by "<weight> <literals> 0" lines, where weights >= top are hard, and the
+  // newer one without header, where hard clauses start with "h"
+  static WeightedFormula* fromWCNF(const char *path) {
+    std::ifstream file(path);
+
+    if (!file.is_open()) {
+      std::cerr << "Unable to open file: " << path << std::endl;
+      return nullptr;
+    }
+
+    WeightedFormula *formula = new WeightedFormula();
+    long top = -1;
+
+    std::string line;
+    while(getline(file, line)) {
+      std::vector<std::string> tokens = std::vector<std::string>();
+      for (auto &token : split(line, " ")) {
+        if (!token.empty()) tokens.push_back(token);
+      }
+
+      if (tokens.size() == 0 || tokens[0] == "c") continue;
+
+      if (tokens[0] == "p") {
+        if (tokens.size() < 4 || tokens[1] != "wcnf") {
+          std::cerr << "Invalid WCNF file." << std::endl;
+          delete formula;
+          return nullptr;
+        }
+
+        if (tokens.size() == 5) {
+          top = std::atol(tokens[4].c_str());
+        }
+
+        continue;
+      }
+
+      bool hard = tokens[0] == "h";
+      long weight = hard ? 0 : std::atol(tokens[0].c_str());
+      if (top > 0 && weight >= top) hard = true;
+
+      std::vector<Literal> literals = std::vector<Literal>();
+      for (int i = 1; i < (int) tokens.size(); i++) {
+        // Terminator
+        if (tokens[i] == "0") {
+          break;
+        }
+
+        bool negated = tokens[i][0] == '-';
+        int variable = negated ? std::atoi(tokens[i].substr(1).c_str()) : std::atoi(tokens[i].c_str());
+
+        literals.push_back(Literal(variable, negated));
+      }
+
+      Clause clause = Clause(literals);
+      if (hard) {
+        formula->addHard(clause);
+      } else if (weight > 0) {
+        formula->addSoft(clause, weight);
+      }
+    }
+
+    return formula;
+  }
+
+};
+
+} // cdcl
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////
+// Headers
+#include <iostream>
+#include <vector>
+#include <set>
+
+///////////////////////////////////////////////////////////////////////////////
+// Namespace
+
+namespace cdcl {
+
+///////////////////////////////////////////////////////////////////////////////
+// Classes
+
+// Parity constraint: the XOR of its variables equals rhs
+class XorConstraint {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Members
+private:
+  std::set<int> m_variables;
+  bool m_rhs;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Constructors
+
+public:
+
+  XorConstraint (std::vector<int> variables, bool rhs = true) {
+    this->m_variables = std::set<int>();
+    this->m_rhs = rhs;
+
+    // x ⊕ x = 0, so variables occurring twice cancel out
+    for (auto variable : variables) {
+      if (this->m_variables.count(variable)) {
+        this->m_variables.erase(variable);
+      } else {
+        this->m_variables.insert(variable);
+      }
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Methods
+
+  std::set<int> variables() {
+    return this->m_variables;
+  }
+
+  bool rhs() {
+    return this->m_rhs;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Operators
+
+  friend std::ostream& operator<< (std::ostream &os, XorConstraint const &x) {
+    os << "( ";
+
+    int variables_counter = 0;
+    for (auto &variable : x.m_variables) {
+      os << variable;
+
+      if (variables_counter != (int) x.m_variables.size() - 1) {
+        os << " ⊕ ";
+        variables_counter++;
+      }
+    }
+
+    os << " = " << (x.m_rhs ? "⊤" : "⊥") << " )";
+
+    return os;
+  }
+
+};
+
+} // cdcl
\ No newline at end of file